@@ -27,6 +27,7 @@
 /* Standard includes. */
 #include <string.h>
 #include <stdint.h>
+#include <stdio.h>
 
 /* FreeRTOS includes. */
 #include "FreeRTOS.h"
@@ -49,6 +50,20 @@
 #define configCOMMAND_INT_MAX_OUTPUT_SIZE 256
 #endif
 
+/* FreeRTOS_CLIRegisterCommand() allocates command line list items this many at
+ * a time, so registering many commands costs a few heap blocks rather than one
+ * small block, with its allocator header, per command. */
+#ifndef configCOMMAND_INT_LIST_ITEMS_PER_BLOCK
+#define configCOMMAND_INT_LIST_ITEMS_PER_BLOCK 32
+#endif
+
+/* Alignment of the blocks handed out by FreeRTOS_CLIArenaAlloc(). */
+#ifdef portBYTE_ALIGNMENT
+#define cliARENA_ALIGNMENT portBYTE_ALIGNMENT
+#else
+#define cliARENA_ALIGNMENT 8U
+#endif
+
 /*
  * Register the command passed in using the pxCommandToRegister parameter
  * and using pxCliDefinitionListItemBuffer as the memory for command line
@@ -67,28 +82,256 @@ static BaseType_t prvHelpCommand(char *pcWriteBuffer,
                                  size_t xWriteBufferLen,
                                  const char *pcCommandString);
 
+/*
+ * The body of FreeRTOS_CLIProcessCommand().  If pxResolvedCommand is not NULL
+ * a new command runs it without looking it up or checking its parameters.
+ */
+static BaseType_t prvProcessCommand(CLI_Definition_List_Item_t *pxResolvedCommand,
+                                    const char *const pcCommandInput,
+                                    char *pcWriteBuffer,
+                                    size_t xWriteBufferLen);
+
+/*
+ * Search the list of registered commands for the command that starts
+ * pcCommandInput, as a whole name or, when abbreviations are enabled, as the
+ * only name it abbreviates.  Returns NULL if there is none.  If puxMatches is
+ * not NULL it receives the number of names the input abbreviates, so more than
+ * one means the input was ambiguous.
+ */
+static CLI_Definition_List_Item_t *prvFindCommand(const char *const pcCommandInput,
+                                                  UBaseType_t *puxMatches);
+
+/*
+ * Return how pcCommandInput, whose first word is xInputLength long, matches the
+ * xNameLength long command name pcName, as a cliMATCH_xxx value.
+ */
+static UBaseType_t prvMatchName(const char *pcName,
+                                size_t xNameLength,
+                                const char *const pcCommandInput,
+                                size_t xInputLength);
+
+/*
+ * Return the best match of the first word of pcCommandInput among the space
+ * separated command names in pcNames, adding the number of names it
+ * abbreviates to *puxPrefixes if puxPrefixes is not NULL.
+ */
+static UBaseType_t prvMatchNames(const char *pcNames,
+                                 const char *const pcCommandInput,
+                                 UBaseType_t *puxPrefixes);
+
+/*
+ * Write the error for an input that abbreviates several command names.  In
+ * human mode the names are listed.
+ */
+static void prvWriteAmbiguity(const char *const pcCommandInput,
+                              char *pcWriteBuffer,
+                              size_t xWriteBufferLen);
+
+/*
+ * Call the loader of the command group stub pxStub, and remove the stub from
+ * the list of registered commands if the group was loaded.
+ */
+static BaseType_t prvLoadGroup(CLI_Definition_List_Item_t *pxStub,
+                               char *pcWriteBuffer,
+                               size_t xWriteBufferLen,
+                               const char *const pcCommandInput);
+
+/*
+ * Mark the command in progress in pxContext as finished: record its arena
+ * usage, release the arena and clear the per-command state.
+ */
+static void prvCompleteCommand(CLI_Command_Context_t *pxContext);
+
 /*
  * Return the number of parameters that follow the command name.
  */
 static int8_t prvGetNumberOfParameters(const char *pcCommandString);
 
+/*
+ * Append xLength bytes to the record's buffer, or mark the record as full if
+ * they do not fit.  One byte is always kept for the string terminator.
+ */
+static void prvRecordPut(CLI_Record_t *pxRecord,
+                         const void *pvData,
+                         size_t xLength);
+
+/*
+ * Append a CBOR item head of major type ucMajor with argument ulValue.
+ */
+static void prvRecordPutCborHead(CLI_Record_t *pxRecord,
+                                 uint8_t ucMajor,
+                                 uint32_t ulValue);
+
+/*
+ * Append the key of a new field of the record in progress.
+ */
+static void prvRecordPutKey(CLI_Record_t *pxRecord,
+                            const char *pcKey);
+
+/*
+ * Append a value rendered as text (text and JSON formats).  The first field
+ * of a text record is padded to the name column.  If xQuote is pdTRUE the
+ * value is a JSON string and is quoted and escaped.
+ */
+static void prvRecordPutText(CLI_Record_t *pxRecord,
+                             const char *pcValue,
+                             BaseType_t xQuote);
+
+#if (configCOMMAND_INT_USE_SCHEMA == 1)
+
+/*
+ * The callback function that is executed when "cli-schema" is entered.  Lists
+ * the interface of every registered command as records, for host tooling.
+ */
+static BaseType_t prvSchemaCommand(char *pcWriteBuffer,
+                                   size_t xWriteBufferLen,
+                                   const char *pcCommandString);
+
+#endif /* configCOMMAND_INT_USE_SCHEMA */
+
+#if (configCOMMAND_INT_USE_STATS == 1)
+
+/*
+ * The callback function that is executed when "stats" is entered.  Lists the
+ * execution statistics of every registered command, one command per call.
+ */
+static BaseType_t prvStatsCommand(char *pcWriteBuffer,
+                                  size_t xWriteBufferLen,
+                                  const char *pcCommandString);
+
+/*
+ * Add the time run since ulCallStartTime to the current call of the executing
+ * command, then restart the measurement from now.
+ */
+static void prvAccumulateCallTime(void);
+
+#endif /* configCOMMAND_INT_USE_STATS */
+
 /* The definition of the "help" command.  This command is always at the front
  * of the list of registered commands. */
 static const CLI_Command_Definition_t xHelpCommand =
     {
-        "help",
-        "\r\nhelp:\r\n Lists all the registered commands\r\n\r\n",
-        prvHelpCommand,
-        0};
+        .pcCommand = "help",
+        .pcHelpString = "\r\nhelp:\r\n Lists all the registered commands\r\n\r\n",
+        .pxCommandInterpreter = prvHelpCommand,
+        .cExpectedNumberOfParameters = 0,
+};
+
+#if (configCOMMAND_INT_USE_SCHEMA == 1)
+
+/* The definition of the "cli-schema" command.  It follows the other built-in
+ * commands in the list of registered commands. */
+static const CLI_Command_Definition_t xSchemaCommand =
+    {
+        .pcCommand = "cli-schema",
+        .pcHelpString = "\r\ncli-schema:\r\n Lists the name, parameters and flags of all the registered commands\r\n\r\n",
+        .pxCommandInterpreter = prvSchemaCommand,
+        .cExpectedNumberOfParameters = 0,
+};
+
+static CLI_Definition_List_Item_t xSchemaListItem =
+    {
+        .pxCommandLineDefinition = &xSchemaCommand,
+        .pxNext = NULL,
+};
+
+#define cliSCHEMA_LIST_ITEM (&xSchemaListItem)
+#else
+#define cliSCHEMA_LIST_ITEM NULL
+#endif /* configCOMMAND_INT_USE_SCHEMA */
+
+#if (configCOMMAND_INT_USE_STATS == 1)
+
+/* The definition of the "stats" command.  It always follows the help command
+ * in the list of registered commands. */
+static const CLI_Command_Definition_t xStatsCommand =
+    {
+        .pcCommand = "stats",
+        .pcHelpString = "\r\nstats:\r\n Lists run time statistics of all the registered commands\r\n\r\n",
+        .pxCommandInterpreter = prvStatsCommand,
+        .cExpectedNumberOfParameters = 0,
+};
+
+static CLI_Definition_List_Item_t xStatsListItem =
+    {
+        .pxCommandLineDefinition = &xStatsCommand,
+        .pxNext = cliSCHEMA_LIST_ITEM,
+};
+
+/* The command currently being executed, and the time accounting of the call
+ * to its callback that is in progress.  Used by FreeRTOS_CLIYieldCheck(). */
+static CLI_Definition_List_Item_t *pxExecutingCommand = NULL;
+static uint32_t ulCallStartTime = 0;
+static uint32_t ulCallRunTime = 0;
+static BaseType_t xCallOverrun = pdFALSE;
+
+#define cliFIRST_REGISTERED_ITEM (&xStatsListItem)
+#else
+#define cliFIRST_REGISTERED_ITEM cliSCHEMA_LIST_ITEM
+#endif /* configCOMMAND_INT_USE_STATS */
+
+/* The messages of the cliERROR_xxx errors, indexed by error number.  Shared by
+ * the interpreter and the command callbacks so each sentence is stored once. */
+typedef struct xCLI_ERROR_MESSAGE
+{
+    const char *pcTag;     /* Written after the error number in terse mode. */
+    const char *pcMessage; /* Written in human mode. */
+} CLI_Error_Message_t;
+
+static const CLI_Error_Message_t xErrorMessages[] =
+    {
+        {"err", "Command failed.\r\n"},
+        {"cmd", "Command not recognized.  Enter 'help' to view a list of available commands.\r\n\r\n"},
+        {"argc", "Incorrect command parameter(s).  Enter \"help\" to view a list of available commands.\r\n\r\n"},
+        {"arg", "Invalid parameter.\r\n"},
+        {"none", "Not found.\r\n"},
+        {"pend", "Too many uncommitted changes, commit first.\r\n"},
+        {"full", "No space left.\r\n"},
+        {"flash", "Flash error.\r\n"},
+        {"load", "Command unavailable.\r\n"},
+        {"nest", "Scripts cannot execute scripts.\r\n"},
+        {"ambig", "Ambiguous command.\r\n"}};
+
+#define cliERROR_COUNT (sizeof(xErrorMessages) / sizeof(xErrorMessages[0]))
+
+/* Case of a character of a command name as it is compared. */
+#if (configCOMMAND_INT_FOLD_CASE == 1)
+#define cliFOLD(c) ((((c) >= 'A') && ((c) <= 'Z')) ? (char)((c) + ('a' - 'A')) : (c))
+#else
+#define cliFOLD(c) (c)
+#endif
 
 /* The definition of the list of commands.  Commands that are registered are
  * added to this list. */
 static CLI_Definition_List_Item_t xRegisteredCommands =
     {
-        &xHelpCommand, /* The first command in the list is always the help command, defined in this file. */
-        NULL           /* The next pointer is initialised to NULL, as there are no other registered commands yet. */
+        .pxCommandLineDefinition = &xHelpCommand, /* The first command in the list is always the help command, defined in this file. */
+        .pxNext = cliFIRST_REGISTERED_ITEM        /* The next pointer points at the other built-in commands, if any, until commands are registered. */
 };
 
+/* The last item in the list of registered commands. */
+#if (configCOMMAND_INT_USE_SCHEMA == 1)
+static CLI_Definition_List_Item_t *pxLastCommandInList = &xSchemaListItem;
+#elif (configCOMMAND_INT_USE_STATS == 1)
+static CLI_Definition_List_Item_t *pxLastCommandInList = &xStatsListItem;
+#else
+static CLI_Definition_List_Item_t *pxLastCommandInList = &xRegisteredCommands;
+#endif
+
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
+
+/* The block list items are currently taken from by FreeRTOS_CLIRegisterCommand(),
+ * and the number of items in it that are still free. */
+static CLI_Definition_List_Item_t *pxListItemBlock = NULL;
+static UBaseType_t uxFreeListItems = 0;
+
+#endif
+
+/* The context used when the console has not bound one of its own, and the
+ * context FreeRTOS_CLIProcessCommand() currently works on. */
+static CLI_Command_Context_t xDefaultContext = {.pxCommand = NULL, .pucArena = NULL, .xStatus = cliSTATUS_OK};
+static CLI_Command_Context_t *pxCurrentContext = &xDefaultContext;
+
 /* A buffer into which command outputs can be written is declared here, rather
  * than in the command console implementation, to allow multiple command consoles
  * to share the same buffer.  For example, an application may allow access to the
@@ -119,8 +362,33 @@ BaseType_t FreeRTOS_CLIRegisterCommand(const CLI_Command_Definition_t *const pxC
     /* Check the parameter is not NULL. */
     configASSERT(pxCommandToRegister != NULL);
 
-    /* Create a new list item that will reference the command being registered. */
-    pxNewListItem = (CLI_Definition_List_Item_t *)pvPortMalloc(sizeof(CLI_Definition_List_Item_t));
+    /* Take a new list item that will reference the command being registered
+     * from the current block, allocating a new block once it is used up.  Items
+     * are never freed, so a block is never returned to the heap either. */
+    vTaskSuspendAll();
+    {
+        if (uxFreeListItems == 0U)
+        {
+            pxListItemBlock = (CLI_Definition_List_Item_t *)pvPortMalloc(configCOMMAND_INT_LIST_ITEMS_PER_BLOCK * sizeof(CLI_Definition_List_Item_t));
+
+            if (pxListItemBlock != NULL)
+            {
+                uxFreeListItems = configCOMMAND_INT_LIST_ITEMS_PER_BLOCK;
+            }
+        }
+
+        if (uxFreeListItems != 0U)
+        {
+            pxNewListItem = &pxListItemBlock[configCOMMAND_INT_LIST_ITEMS_PER_BLOCK - uxFreeListItems];
+            uxFreeListItems--;
+        }
+        else
+        {
+            pxNewListItem = NULL;
+        }
+    }
+    (void)xTaskResumeAll();
+
     configASSERT(pxNewListItem != NULL);
 
     if (pxNewListItem != NULL)
@@ -156,154 +424,741 @@ BaseType_t FreeRTOS_CLIProcessCommand(const char *const pcCommandInput,
                                       char *pcWriteBuffer,
                                       size_t xWriteBufferLen)
 {
-    static const CLI_Definition_List_Item_t *pxCommand = NULL;
+    return prvProcessCommand(NULL, pcCommandInput, pcWriteBuffer, xWriteBufferLen);
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t FreeRTOS_CLIProcessResolvedCommand(CLI_Definition_List_Item_t *pxResolvedCommand,
+                                              const char *const pcCommandInput,
+                                              char *pcWriteBuffer,
+                                              size_t xWriteBufferLen)
+{
+    configASSERT(pxResolvedCommand != NULL);
+
+    return prvProcessCommand(pxResolvedCommand, pcCommandInput, pcWriteBuffer, xWriteBufferLen);
+}
+/*-----------------------------------------------------------*/
+
+CLI_Definition_List_Item_t *FreeRTOS_CLIResolveCommand(const char *const pcCommandInput,
+                                                       char *pcWriteBuffer,
+                                                       size_t xWriteBufferLen)
+{
+    CLI_Definition_List_Item_t *pxCommand = prvFindCommand(pcCommandInput, NULL);
+
+    if ((pxCommand != NULL) &&
+        ((pxCommand->pxCommandLineDefinition->ucFlags & cliCOMMAND_FLAG_GROUP) != 0U))
+    {
+        pxCommand = (prvLoadGroup(pxCommand, pcWriteBuffer, xWriteBufferLen, pcCommandInput) == pdPASS) ? prvFindCommand(pcCommandInput, NULL) : NULL;
+
+        if ((pxCommand != NULL) &&
+            ((pxCommand->pxCommandLineDefinition->ucFlags & cliCOMMAND_FLAG_GROUP) != 0U))
+        {
+            pxCommand = NULL;
+        }
+    }
+
+    return pxCommand;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvProcessCommand(CLI_Definition_List_Item_t *pxResolvedCommand,
+                                    const char *const pcCommandInput,
+                                    char *pcWriteBuffer,
+                                    size_t xWriteBufferLen)
+{
+    CLI_Definition_List_Item_t *pxCommand = pxCurrentContext->pxCommand;
     BaseType_t xReturn = pdTRUE;
-    const char *pcRegisteredCommandString;
-    size_t xCommandStringLength;
+    BaseType_t xFirstCall = pdFALSE;
+    UBaseType_t uxMatches = 0U;
+#if (configCOMMAND_INT_USE_STATS == 1)
+    uint32_t ulPhaseStart = configCOMMAND_INT_GET_TIME();
+#endif
 
     /* Note:  This function is not re-entrant.  It must not be called from more
      * thank one task. */
 
+    /* The output is a string unless the callback writes binary records. */
+    pxCurrentContext->xOutputLength = 0U;
+
     if (pxCommand == NULL)
     {
-        /* Search for the command string in the list of registered commands. */
-        for (pxCommand = &xRegisteredCommands; pxCommand != NULL; pxCommand = pxCommand->pxNext)
+        xFirstCall = pdTRUE;
+
+        /* A new command starts with a clean context. */
+        prvCompleteCommand(pxCurrentContext);
+        pxCurrentContext->xStatus = cliSTATUS_OK;
+
+#if (configCOMMAND_INT_USE_STATS == 1)
+        pxCurrentContext->ulParseTime = 0U;
+        pxCurrentContext->ulExecuteTime = 0U;
+#endif
+
+        /* Search for the command string in the list of registered commands,
+         * unless the caller has already resolved it. */
+        pxCommand = (pxResolvedCommand != NULL) ? pxResolvedCommand : prvFindCommand(pcCommandInput, &uxMatches);
+
+        /* If the command belongs to a group that has not been used yet, load
+         * the group and look the command up again among the group's commands. */
+        if ((pxCommand != NULL) &&
+            ((pxCommand->pxCommandLineDefinition->ucFlags & cliCOMMAND_FLAG_GROUP) != 0U))
         {
-            pcRegisteredCommandString = pxCommand->pxCommandLineDefinition->pcCommand;
-            xCommandStringLength = strlen(pcRegisteredCommandString);
+            if (prvLoadGroup(pxCommand, pcWriteBuffer, xWriteBufferLen, pcCommandInput) != pdPASS)
+            {
+                pxCurrentContext->xStatus = cliSTATUS_FAILED;
+                return pdFALSE;
+            }
+
+            pxCommand = prvFindCommand(pcCommandInput, &uxMatches);
 
-            /* To ensure the string lengths match exactly, so as not to pick up
-             * a sub-string of a longer command, check the byte after the expected
-             * end of the string is either the end of the string or a space before
-             * a parameter. */
-            if (strncmp(pcCommandInput, pcRegisteredCommandString, xCommandStringLength) == 0)
+            if ((pxCommand != NULL) &&
+                ((pxCommand->pxCommandLineDefinition->ucFlags & cliCOMMAND_FLAG_GROUP) != 0U))
             {
-                if ((pcCommandInput[xCommandStringLength] == ' ') || (pcCommandInput[xCommandStringLength] == 0x00))
-                {
-                    /* The command has been found.  Check it has the expected
-                     * number of parameters.  If cExpectedNumberOfParameters is -1,
-                     * then there could be a variable number of parameters and no
-                     * check is made. */
-                    if (pxCommand->pxCommandLineDefinition->cExpectedNumberOfParameters >= 0)
-                    {
-                        if (prvGetNumberOfParameters(pcCommandInput) != pxCommand->pxCommandLineDefinition->cExpectedNumberOfParameters)
-                        {
-                            xReturn = pdFALSE;
-                        }
-                    }
-
-                    break;
-                }
+                /* The group did not register the command it claimed to provide. */
+                pxCommand = NULL;
             }
         }
+
+#if (configCOMMAND_INT_USE_STATS == 1)
+        pxCurrentContext->ulLookupTime = configCOMMAND_INT_GET_TIME() - ulPhaseStart;
+        ulPhaseStart += pxCurrentContext->ulLookupTime;
+#endif
+
+        /* Check the command has the expected number of parameters.  If
+         * cExpectedNumberOfParameters is -1, then there could be a variable
+         * number of parameters and no check is made.  The caller of
+         * FreeRTOS_CLIProcessResolvedCommand() has made the check already. */
+        if ((pxCommand != NULL) &&
+            (pxResolvedCommand == NULL) &&
+            (pxCommand->pxCommandLineDefinition->cExpectedNumberOfParameters >= 0))
+        {
+            if (prvGetNumberOfParameters(pcCommandInput) != pxCommand->pxCommandLineDefinition->cExpectedNumberOfParameters)
+            {
+                xReturn = pdFALSE;
+            }
+
+#if (configCOMMAND_INT_USE_STATS == 1)
+            pxCurrentContext->ulParseTime = configCOMMAND_INT_GET_TIME() - ulPhaseStart;
+#endif
+        }
     }
 
     if ((pxCommand != NULL) && (xReturn == pdFALSE))
     {
         /* The command was found, but the number of parameters with the command
          * was incorrect. */
-        strncpy(pcWriteBuffer, "Incorrect command parameter(s).  Enter \"help\" to view a list of available commands.\r\n\r\n", xWriteBufferLen);
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_PARAMETER_COUNT, NULL);
+        pxCurrentContext->xStatus = cliSTATUS_BAD_PARAMETERS;
         pxCommand = NULL;
     }
     else if (pxCommand != NULL)
     {
+#if (configCOMMAND_INT_USE_STATS == 1)
+        /* The callback may itself run a command, save the accounting of any
+         * call this one is nested in. */
+        CLI_Definition_List_Item_t *const pxOuterCommand = pxExecutingCommand;
+        const uint32_t ulOuterStartTime = ulCallStartTime;
+        const uint32_t ulOuterRunTime = ulCallRunTime;
+        const BaseType_t xOuterOverrun = xCallOverrun;
+
+        if (xFirstCall == pdTRUE)
+        {
+            pxCommand->xStats.ulInvocations++;
+        }
+
+        pxExecutingCommand = pxCommand;
+        ulCallRunTime = 0;
+        xCallOverrun = pdFALSE;
+        ulCallStartTime = configCOMMAND_INT_GET_TIME();
+#else
+        (void)xFirstCall;
+#endif
+
         /* Call the callback function that is registered to this command. */
         xReturn = pxCommand->pxCommandLineDefinition->pxCommandInterpreter(pcWriteBuffer, xWriteBufferLen, pcCommandInput);
 
+#if (configCOMMAND_INT_USE_STATS == 1)
+        prvAccumulateCallTime();
+
+        if ((pxCommand->pxCommandLineDefinition->ulTimeBudget != 0U) &&
+            (ulCallRunTime > pxCommand->pxCommandLineDefinition->ulTimeBudget) &&
+            (xCallOverrun == pdFALSE))
+        {
+            pxCommand->xStats.ulOverruns++;
+        }
+
+        if (ulCallRunTime > pxCommand->xStats.ulMaxTime)
+        {
+            pxCommand->xStats.ulMaxTime = ulCallRunTime;
+        }
+
+        pxCommand->xStats.ulTotalTime += ulCallRunTime;
+        pxCurrentContext->ulExecuteTime += ulCallRunTime;
+
+        pxExecutingCommand = pxOuterCommand;
+        ulCallStartTime = ulOuterStartTime;
+        ulCallRunTime = ulOuterRunTime;
+        xCallOverrun = xOuterOverrun;
+#endif
+
         /* If xReturn is pdFALSE, then no further strings will be returned
          * after this one, and	pxCommand can be reset to NULL ready to search
-         * for the next entered command. */
+         * for the next entered command.  Anything the command allocated from
+         * the arena is released at the same time. */
         if (xReturn == pdFALSE)
         {
+            pxCurrentContext->pxCommand = pxCommand;
+            prvCompleteCommand(pxCurrentContext);
             pxCommand = NULL;
         }
     }
     else
     {
-        /* pxCommand was NULL, the command was not found. */
-        strncpy(pcWriteBuffer, "Command not recognized.  Enter 'help' to view a list of available commands.\r\n\r\n", xWriteBufferLen);
+        /* pxCommand was NULL, the command was not found or the input
+         * abbreviates more than one command. */
+        if (uxMatches > 1U)
+        {
+            prvWriteAmbiguity(pcCommandInput, pcWriteBuffer, xWriteBufferLen);
+        }
+        else
+        {
+            FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_UNKNOWN_COMMAND, NULL);
+        }
+
+        pxCurrentContext->xStatus = cliSTATUS_NOT_FOUND;
         xReturn = pdFALSE;
     }
 
+    pxCurrentContext->pxCommand = pxCommand;
+
     return xReturn;
 }
 /*-----------------------------------------------------------*/
 
-char *FreeRTOS_CLIGetOutputBuffer(void)
+CLI_Definition_List_Item_t *FreeRTOS_CLIFindCommand(const char *const pcCommandInput)
 {
-    return cOutputBuffer;
+    configASSERT(pcCommandInput != NULL);
+
+    return prvFindCommand(pcCommandInput, NULL);
 }
 /*-----------------------------------------------------------*/
 
-const char *FreeRTOS_CLIGetParameter(const char *pcCommandString,
-                                     UBaseType_t uxWantedParameter,
-                                     BaseType_t *pxParameterStringLength)
+UBaseType_t FreeRTOS_CLIMatchName(const char *pcNames,
+                                  const char *const pcCommandInput)
 {
-    UBaseType_t uxParametersFound = 0;
-    const char *pcReturn = NULL;
+    configASSERT((pcNames != NULL) && (pcCommandInput != NULL));
 
-    *pxParameterStringLength = 0;
+    return prvMatchNames(pcNames, pcCommandInput, NULL);
+}
+/*-----------------------------------------------------------*/
 
-    while (uxParametersFound < uxWantedParameter)
-    {
-        /* Index the character pointer past the current word.  If this is the start
-         * of the command string then the first word is the command itself. */
-        while (((*pcCommandString) != 0x00) && ((*pcCommandString) != ' '))
-        {
-            pcCommandString++;
-        }
+CLI_Definition_List_Item_t *FreeRTOS_CLIGetNextCommand(const CLI_Definition_List_Item_t *pxItem)
+{
+    return (pxItem == NULL) ? &xRegisteredCommands : pxItem->pxNext;
+}
+/*-----------------------------------------------------------*/
 
-        /* Find the start of the next string. */
-        while (((*pcCommandString) != 0x00) && ((*pcCommandString) == ' '))
-        {
-            pcCommandString++;
-        }
+void FreeRTOS_CLIInitContext(CLI_Command_Context_t *pxContext,
+                             void *pvArena,
+                             size_t xArenaSize)
+{
+    configASSERT(pxContext != NULL);
 
-        /* Was a string found? */
-        if (*pcCommandString != 0x00)
-        {
-            /* Is this the start of the required parameter? */
-            uxParametersFound++;
+    memset(pxContext, 0, sizeof(*pxContext));
+    pxContext->pucArena = (uint8_t *)pvArena;
+    pxContext->xArenaSize = (pvArena != NULL) ? xArenaSize : 0U;
+}
+/*-----------------------------------------------------------*/
 
-            if (uxParametersFound == uxWantedParameter)
-            {
-                /* How long is the parameter? */
-                pcReturn = pcCommandString;
+void FreeRTOS_CLIAbortCommand(void)
+{
+    prvCompleteCommand(pxCurrentContext);
+}
+/*-----------------------------------------------------------*/
 
-                while (((*pcCommandString) != 0x00) && ((*pcCommandString) != ' '))
-                {
-                    (*pxParameterStringLength)++;
-                    pcCommandString++;
-                }
+void FreeRTOS_CLISetStatus(BaseType_t xStatus)
+{
+    pxCurrentContext->xStatus = xStatus;
+}
+/*-----------------------------------------------------------*/
 
-                if (*pxParameterStringLength == 0)
-                {
-                    pcReturn = NULL;
-                }
+BaseType_t FreeRTOS_CLIGetStatus(void)
+{
+    return pxCurrentContext->xStatus;
+}
+/*-----------------------------------------------------------*/
 
-                break;
-            }
-        }
-        else
-        {
-            break;
-        }
-    }
+void FreeRTOS_CLISetVerbosity(uint8_t ucVerbosity)
+{
+    pxCurrentContext->ucVerbosity = ucVerbosity;
+}
+/*-----------------------------------------------------------*/
 
-    return pcReturn;
+uint8_t FreeRTOS_CLIGetVerbosity(void)
+{
+    return pxCurrentContext->ucVerbosity;
 }
 /*-----------------------------------------------------------*/
 
-static void prvRegisterCommand(const CLI_Command_Definition_t *const pxCommandToRegister,
-                               CLI_Definition_List_Item_t *pxCliDefinitionListItemBuffer)
+void FreeRTOS_CLISetFormat(uint8_t ucFormat)
 {
-    static CLI_Definition_List_Item_t *pxLastCommandInList = &xRegisteredCommands;
+    pxCurrentContext->ucFormat = ucFormat;
+}
+/*-----------------------------------------------------------*/
 
-    /* Check the parameters are not NULL. */
-    configASSERT(pxCommandToRegister != NULL);
-    configASSERT(pxCliDefinitionListItemBuffer != NULL);
+uint8_t FreeRTOS_CLIGetFormat(void)
+{
+    return pxCurrentContext->ucFormat;
+}
+/*-----------------------------------------------------------*/
 
-    taskENTER_CRITICAL();
+size_t FreeRTOS_CLIGetOutputLength(const char *pcWriteBuffer)
+{
+    return (pxCurrentContext->xOutputLength != 0U) ? pxCurrentContext->xOutputLength : strlen(pcWriteBuffer);
+}
+/*-----------------------------------------------------------*/
+
+void FreeRTOS_CLIRecordInit(CLI_Record_t *pxRecord,
+                            char *pcWriteBuffer,
+                            size_t xWriteBufferLen)
+{
+    pxRecord->pcBuffer = pcWriteBuffer;
+    pxRecord->xBufferLen = xWriteBufferLen;
+    pxRecord->xLength = 0U;
+    pxRecord->xStart = 0U;
+    pxRecord->ucFormat = pxCurrentContext->ucFormat;
+    pxRecord->ucFields = 0U;
+    pxRecord->xFull = pdFALSE;
+
+    if (xWriteBufferLen > 0U)
+    {
+        pcWriteBuffer[0] = '\0';
+    }
+}
+/*-----------------------------------------------------------*/
+
+void FreeRTOS_CLIRecordBegin(CLI_Record_t *pxRecord)
+{
+    const uint8_t ucEmptyMap = 0xA0U;
+
+    pxRecord->xStart = pxRecord->xLength;
+    pxRecord->ucFields = 0U;
+    pxRecord->xFull = pdFALSE;
+
+    if (pxRecord->ucFormat == cliFORMAT_JSON)
+    {
+        prvRecordPut(pxRecord, "{", 1U);
+    }
+    else if (pxRecord->ucFormat == cliFORMAT_CBOR)
+    {
+        /* The number of fields is patched in by FreeRTOS_CLIRecordEnd(). */
+        prvRecordPut(pxRecord, &ucEmptyMap, 1U);
+    }
+}
+/*-----------------------------------------------------------*/
+
+void FreeRTOS_CLIRecordString(CLI_Record_t *pxRecord,
+                              const char *pcKey,
+                              const char *pcValue)
+{
+    size_t xValueLength = strlen(pcValue);
+
+    prvRecordPutKey(pxRecord, pcKey);
+
+    if (pxRecord->ucFormat == cliFORMAT_CBOR)
+    {
+        prvRecordPutCborHead(pxRecord, 3U, (uint32_t)xValueLength);
+        prvRecordPut(pxRecord, pcValue, xValueLength);
+    }
+    else
+    {
+        prvRecordPutText(pxRecord, pcValue, (pxRecord->ucFormat == cliFORMAT_JSON) ? pdTRUE : pdFALSE);
+    }
+}
+/*-----------------------------------------------------------*/
+
+void FreeRTOS_CLIRecordUnsigned(CLI_Record_t *pxRecord,
+                                const char *pcKey,
+                                uint32_t ulValue)
+{
+    char cNumber[12];
+
+    prvRecordPutKey(pxRecord, pcKey);
+
+    if (pxRecord->ucFormat == cliFORMAT_CBOR)
+    {
+        prvRecordPutCborHead(pxRecord, 0U, ulValue);
+    }
+    else
+    {
+        snprintf(cNumber, sizeof(cNumber), "%lu", (unsigned long)ulValue);
+        prvRecordPutText(pxRecord, cNumber, pdFALSE);
+    }
+}
+/*-----------------------------------------------------------*/
+
+void FreeRTOS_CLIRecordSigned(CLI_Record_t *pxRecord,
+                              const char *pcKey,
+                              int32_t lValue)
+{
+    char cNumber[12];
+
+    prvRecordPutKey(pxRecord, pcKey);
+
+    if (pxRecord->ucFormat == cliFORMAT_CBOR)
+    {
+        /* Negative integers are encoded as -1 - n. */
+        if (lValue < 0)
+        {
+            prvRecordPutCborHead(pxRecord, 1U, (uint32_t)(-(lValue + 1)));
+        }
+        else
+        {
+            prvRecordPutCborHead(pxRecord, 0U, (uint32_t)lValue);
+        }
+    }
+    else
+    {
+        snprintf(cNumber, sizeof(cNumber), "%ld", (long)lValue);
+        prvRecordPutText(pxRecord, cNumber, pdFALSE);
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t FreeRTOS_CLIRecordEnd(CLI_Record_t *pxRecord)
+{
+    BaseType_t xReturn = pdPASS;
+
+    if (pxRecord->ucFormat == cliFORMAT_JSON)
+    {
+        prvRecordPut(pxRecord, "}\r\n", 3U);
+    }
+    else if (pxRecord->ucFormat == cliFORMAT_CBOR)
+    {
+        if (pxRecord->ucFields > 23U)
+        {
+            /* Larger maps would need a longer head than was reserved. */
+            pxRecord->xFull = pdTRUE;
+        }
+        else if (pxRecord->xFull == pdFALSE)
+        {
+            pxRecord->pcBuffer[pxRecord->xStart] = (char)(0xA0U | pxRecord->ucFields);
+        }
+    }
+    else
+    {
+        prvRecordPut(pxRecord, "\r\n", 2U);
+    }
+
+    if (pxRecord->xFull != pdFALSE)
+    {
+        /* Remove what was written of the record. */
+        pxRecord->xLength = pxRecord->xStart;
+        xReturn = pdFAIL;
+    }
+
+    if (pxRecord->xBufferLen > 0U)
+    {
+        pxRecord->pcBuffer[pxRecord->xLength] = '\0';
+    }
+
+    pxCurrentContext->xOutputLength = pxRecord->xLength;
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t FreeRTOS_CLIRecordLength(const CLI_Record_t *pxRecord)
+{
+    return pxRecord->xLength;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRecordPut(CLI_Record_t *pxRecord,
+                         const void *pvData,
+                         size_t xLength)
+{
+    if ((pxRecord->xFull != pdFALSE) ||
+        ((pxRecord->xLength + xLength) >= pxRecord->xBufferLen))
+    {
+        pxRecord->xFull = pdTRUE;
+    }
+    else
+    {
+        memcpy(&pxRecord->pcBuffer[pxRecord->xLength], pvData, xLength);
+        pxRecord->xLength += xLength;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvRecordPutCborHead(CLI_Record_t *pxRecord,
+                                 uint8_t ucMajor,
+                                 uint32_t ulValue)
+{
+    uint8_t ucHead[5];
+    size_t xLength;
+
+    ucMajor = (uint8_t)(ucMajor << 5);
+
+    if (ulValue < 24U)
+    {
+        ucHead[0] = (uint8_t)(ucMajor | ulValue);
+        xLength = 1U;
+    }
+    else if (ulValue <= 0xFFU)
+    {
+        ucHead[0] = (uint8_t)(ucMajor | 24U);
+        ucHead[1] = (uint8_t)ulValue;
+        xLength = 2U;
+    }
+    else if (ulValue <= 0xFFFFU)
+    {
+        ucHead[0] = (uint8_t)(ucMajor | 25U);
+        ucHead[1] = (uint8_t)(ulValue >> 8);
+        ucHead[2] = (uint8_t)ulValue;
+        xLength = 3U;
+    }
+    else
+    {
+        ucHead[0] = (uint8_t)(ucMajor | 26U);
+        ucHead[1] = (uint8_t)(ulValue >> 24);
+        ucHead[2] = (uint8_t)(ulValue >> 16);
+        ucHead[3] = (uint8_t)(ulValue >> 8);
+        ucHead[4] = (uint8_t)ulValue;
+        xLength = 5U;
+    }
+
+    prvRecordPut(pxRecord, ucHead, xLength);
+}
+/*-----------------------------------------------------------*/
+
+static void prvRecordPutKey(CLI_Record_t *pxRecord,
+                            const char *pcKey)
+{
+    size_t xKeyLength = strlen(pcKey);
+
+    if (pxRecord->ucFormat == cliFORMAT_CBOR)
+    {
+        prvRecordPutCborHead(pxRecord, 3U, (uint32_t)xKeyLength);
+        prvRecordPut(pxRecord, pcKey, xKeyLength);
+    }
+    else if (pxRecord->ucFormat == cliFORMAT_JSON)
+    {
+        if (pxRecord->ucFields != 0U)
+        {
+            prvRecordPut(pxRecord, ",", 1U);
+        }
+
+        prvRecordPut(pxRecord, "\"", 1U);
+        prvRecordPut(pxRecord, pcKey, xKeyLength);
+        prvRecordPut(pxRecord, "\":", 2U);
+    }
+    else if (pxRecord->ucFields != 0U)
+    {
+        /* As text, the first field is the name column and has no key.
+         * The column is padded only once a second field follows it. */
+        if (pxRecord->ucFields == 1U)
+        {
+            while ((pxRecord->xFull == pdFALSE) &&
+                   ((pxRecord->xLength - pxRecord->xStart) < configCOMMAND_INT_RECORD_NAME_WIDTH))
+            {
+                prvRecordPut(pxRecord, " ", 1U);
+            }
+        }
+
+        prvRecordPut(pxRecord, " ", 1U);
+        prvRecordPut(pxRecord, pcKey, xKeyLength);
+        prvRecordPut(pxRecord, "=", 1U);
+    }
+
+    pxRecord->ucFields++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRecordPutText(CLI_Record_t *pxRecord,
+                             const char *pcValue,
+                             BaseType_t xQuote)
+{
+    size_t xValueLength = strlen(pcValue);
+    char cEscape[7];
+
+    if (xQuote == pdFALSE)
+    {
+        prvRecordPut(pxRecord, pcValue, xValueLength);
+        return;
+    }
+
+    prvRecordPut(pxRecord, "\"", 1U);
+
+    for (; *pcValue != '\0'; pcValue++)
+    {
+        if ((*pcValue == '"') || (*pcValue == '\\'))
+        {
+            cEscape[0] = '\\';
+            cEscape[1] = *pcValue;
+            prvRecordPut(pxRecord, cEscape, 2U);
+        }
+        else if ((*pcValue == '\r') || (*pcValue == '\n'))
+        {
+            /* Help strings are full of line ends, keep them short. */
+            cEscape[0] = '\\';
+            cEscape[1] = (*pcValue == '\r') ? 'r' : 'n';
+            prvRecordPut(pxRecord, cEscape, 2U);
+        }
+        else if ((uint8_t)*pcValue < 0x20U)
+        {
+            snprintf(cEscape, sizeof(cEscape), "\\u%04x", (unsigned)(uint8_t)*pcValue);
+            prvRecordPut(pxRecord, cEscape, 6U);
+        }
+        else
+        {
+            prvRecordPut(pxRecord, pcValue, 1U);
+        }
+    }
+
+    prvRecordPut(pxRecord, "\"", 1U);
+}
+/*-----------------------------------------------------------*/
+
+void FreeRTOS_CLIWriteError(char *pcWriteBuffer,
+                            size_t xWriteBufferLen,
+                            UBaseType_t uxError,
+                            const char *pcHumanMessage)
+{
+    CLI_Record_t xRecord;
+
+    if (uxError >= cliERROR_COUNT)
+    {
+        uxError = 0;
+    }
+
+    if (pxCurrentContext->ucFormat != cliFORMAT_TEXT)
+    {
+        FreeRTOS_CLIRecordInit(&xRecord, pcWriteBuffer, xWriteBufferLen);
+        FreeRTOS_CLIRecordBegin(&xRecord);
+        FreeRTOS_CLIRecordUnsigned(&xRecord, "error", (uint32_t)uxError);
+        FreeRTOS_CLIRecordString(&xRecord, "tag", xErrorMessages[uxError].pcTag);
+        (void)FreeRTOS_CLIRecordEnd(&xRecord);
+    }
+    else if (pxCurrentContext->ucVerbosity == cliVERBOSITY_TERSE)
+    {
+        snprintf(pcWriteBuffer, xWriteBufferLen, "E%02u %s\r\n", (unsigned)uxError, xErrorMessages[uxError].pcTag);
+    }
+    else
+    {
+        strncpy(pcWriteBuffer, (pcHumanMessage != NULL) ? pcHumanMessage : xErrorMessages[uxError].pcMessage, xWriteBufferLen);
+    }
+}
+/*-----------------------------------------------------------*/
+
+void *FreeRTOS_CLIArenaAlloc(size_t xSize)
+{
+    CLI_Command_Context_t *pxContext = pxCurrentContext;
+    void *pvReturn = NULL;
+    size_t xOffset;
+
+    if (pxContext->pucArena != NULL)
+    {
+        /* Align the block on its address rather than on its offset, as the
+         * console's arena buffer need not be aligned itself. */
+        xOffset = pxContext->xArenaUsed;
+        xOffset += (size_t)(-((uintptr_t)&pxContext->pucArena[xOffset])) & (cliARENA_ALIGNMENT - 1U);
+
+        if ((xOffset <= pxContext->xArenaSize) && (xSize <= (pxContext->xArenaSize - xOffset)))
+        {
+            pvReturn = &pxContext->pucArena[xOffset];
+            pxContext->xArenaUsed = xOffset + xSize;
+        }
+    }
+
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void FreeRTOS_CLISetContext(CLI_Command_Context_t *pxContext)
+{
+    pxCurrentContext = (pxContext != NULL) ? pxContext : &xDefaultContext;
+}
+/*-----------------------------------------------------------*/
+
+CLI_Command_Context_t *FreeRTOS_CLIGetContext(void)
+{
+    return pxCurrentContext;
+}
+/*-----------------------------------------------------------*/
+
+char *FreeRTOS_CLIGetOutputBuffer(void)
+{
+    return cOutputBuffer;
+}
+/*-----------------------------------------------------------*/
+
+const char *FreeRTOS_CLIGetParameter(const char *pcCommandString,
+                                     UBaseType_t uxWantedParameter,
+                                     BaseType_t *pxParameterStringLength)
+{
+    UBaseType_t uxParametersFound = 0;
+    const char *pcReturn = NULL;
+
+    *pxParameterStringLength = 0;
+
+    while (uxParametersFound < uxWantedParameter)
+    {
+        /* Index the character pointer past the current word.  If this is the start
+         * of the command string then the first word is the command itself. */
+        while (((*pcCommandString) != 0x00) && ((*pcCommandString) != ' '))
+        {
+            pcCommandString++;
+        }
+
+        /* Find the start of the next string. */
+        while (((*pcCommandString) != 0x00) && ((*pcCommandString) == ' '))
+        {
+            pcCommandString++;
+        }
+
+        /* Was a string found? */
+        if (*pcCommandString != 0x00)
+        {
+            /* Is this the start of the required parameter? */
+            uxParametersFound++;
+
+            if (uxParametersFound == uxWantedParameter)
+            {
+                /* How long is the parameter? */
+                pcReturn = pcCommandString;
+
+                while (((*pcCommandString) != 0x00) && ((*pcCommandString) != ' '))
+                {
+                    (*pxParameterStringLength)++;
+                    pcCommandString++;
+                }
+
+                if (*pxParameterStringLength == 0)
+                {
+                    pcReturn = NULL;
+                }
+
+                break;
+            }
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    return pcReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRegisterCommand(const CLI_Command_Definition_t *const pxCommandToRegister,
+                               CLI_Definition_List_Item_t *pxCliDefinitionListItemBuffer)
+{
+    /* Check the parameters are not NULL. */
+    configASSERT(pxCommandToRegister != NULL);
+    configASSERT(pxCliDefinitionListItemBuffer != NULL);
+
+    taskENTER_CRITICAL();
     {
         /* Reference the command being registered from the newly created
          * list item. */
@@ -313,6 +1168,10 @@ static void prvRegisterCommand(const CLI_Command_Definition_t *const pxCommandTo
          * pxNext has nowhere to point. */
         pxCliDefinitionListItemBuffer->pxNext = NULL;
 
+#if (configCOMMAND_INT_USE_STATS == 1)
+        memset(&pxCliDefinitionListItemBuffer->xStats, 0, sizeof(pxCliDefinitionListItemBuffer->xStats));
+#endif
+
         /* Add the newly created list item to the end of the already existing
          * list. */
         pxLastCommandInList->pxNext = pxCliDefinitionListItemBuffer;
@@ -328,31 +1187,460 @@ static BaseType_t prvHelpCommand(char *pcWriteBuffer,
                                  size_t xWriteBufferLen,
                                  const char *pcCommandString)
 {
-    static const CLI_Definition_List_Item_t *pxCommand = NULL;
-    BaseType_t xReturn;
+    CLI_Command_Context_t *pxContext = FreeRTOS_CLIGetContext();
+    const CLI_Definition_List_Item_t *pxCommand;
 
     (void)pcCommandString;
 
-    if (pxCommand == NULL)
+    cliCOROUTINE_BEGIN(pxContext);
+
+    for (pxContext->pvCursor = &xRegisteredCommands; pxContext->pvCursor != NULL;)
+    {
+        /* Return the next command help string, before moving the cursor on to
+         * the next command in the list. */
+        pxCommand = (const CLI_Definition_List_Item_t *)pxContext->pvCursor;
+        strncpy(pcWriteBuffer, pxCommand->pxCommandLineDefinition->pcHelpString, xWriteBufferLen);
+        pxContext->pvCursor = pxCommand->pxNext;
+
+        /* The last string is returned together with pdFALSE by
+         * cliCOROUTINE_END(), as there will be nothing more to return. */
+        if (pxContext->pvCursor != NULL)
+        {
+            cliCOROUTINE_YIELD(pxContext);
+        }
+    }
+
+    cliCOROUTINE_END(pxContext);
+}
+/*-----------------------------------------------------------*/
+
+#if (configCOMMAND_INT_USE_SCHEMA == 1)
+
+static BaseType_t prvSchemaCommand(char *pcWriteBuffer,
+                                   size_t xWriteBufferLen,
+                                   const char *pcCommandString)
+{
+    CLI_Command_Context_t *pxContext = FreeRTOS_CLIGetContext();
+    const CLI_Definition_List_Item_t *pxCommand;
+    const CLI_Command_Definition_t *pxDefinition;
+    CLI_Record_t xRecord;
+    BaseType_t xWithHelp;
+
+    (void)pcCommandString;
+
+    FreeRTOS_CLIRecordInit(&xRecord, pcWriteBuffer, xWriteBufferLen);
+
+    /* The help string spans lines, so it is left to "help" in text. */
+    xWithHelp = (xRecord.ucFormat != cliFORMAT_TEXT) ? pdTRUE : pdFALSE;
+
+    /* The first record gives the version of the layout of the records that
+     * follow, so a host generator can reject a schema it does not know. */
+    if (pxContext->pvCursor == NULL)
+    {
+        FreeRTOS_CLIRecordBegin(&xRecord);
+        FreeRTOS_CLIRecordString(&xRecord, "schema", "cli");
+        FreeRTOS_CLIRecordUnsigned(&xRecord, "version", cliSCHEMA_VERSION);
+        (void)FreeRTOS_CLIRecordEnd(&xRecord);
+
+        pxContext->pvCursor = &xRegisteredCommands;
+    }
+
+    /* As many commands as fit are written per call.  A group stub that has not
+     * been loaded yet is listed with cliCOMMAND_FLAG_GROUP set, its name being
+     * the names of the group's commands. */
+    while (pxContext->pvCursor != NULL)
+    {
+        pxCommand = (const CLI_Definition_List_Item_t *)pxContext->pvCursor;
+        pxDefinition = pxCommand->pxCommandLineDefinition;
+
+        FreeRTOS_CLIRecordBegin(&xRecord);
+        FreeRTOS_CLIRecordString(&xRecord, "command", pxDefinition->pcCommand);
+        FreeRTOS_CLIRecordSigned(&xRecord, "args", pxDefinition->cExpectedNumberOfParameters);
+        FreeRTOS_CLIRecordUnsigned(&xRecord, "flags", pxDefinition->ucFlags);
+        FreeRTOS_CLIRecordUnsigned(&xRecord, "budget", pxDefinition->ulTimeBudget);
+        FreeRTOS_CLIRecordUnsigned(&xRecord, "stack", pxDefinition->usStackDepth);
+
+        if (xWithHelp == pdTRUE)
+        {
+            FreeRTOS_CLIRecordString(&xRecord, "help", pxDefinition->pcHelpString);
+        }
+
+        if (FreeRTOS_CLIRecordEnd(&xRecord) != pdPASS)
+        {
+            if (FreeRTOS_CLIRecordLength(&xRecord) != 0U)
+            {
+                /* Written again at the start of the next chunk. */
+                return pdTRUE;
+            }
+
+            if (xWithHelp == pdTRUE)
+            {
+                /* Too long for any chunk, so the command is listed without
+                 * its help string rather than not at all. */
+                xWithHelp = pdFALSE;
+                continue;
+            }
+        }
+
+        xWithHelp = (xRecord.ucFormat != cliFORMAT_TEXT) ? pdTRUE : pdFALSE;
+        pxContext->pvCursor = pxCommand->pxNext;
+    }
+
+    return pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configCOMMAND_INT_USE_SCHEMA */
+
+#if (configCOMMAND_INT_USE_STATS == 1)
+
+BaseType_t FreeRTOS_CLIYieldCheck(void)
+{
+    BaseType_t xReturn = pdFALSE;
+    const CLI_Command_Definition_t *pxDefinition;
+
+    if (pxExecutingCommand != NULL)
+    {
+        pxDefinition = pxExecutingCommand->pxCommandLineDefinition;
+
+        if ((pxDefinition->ulTimeBudget != 0U) &&
+            ((ulCallRunTime + (configCOMMAND_INT_GET_TIME() - ulCallStartTime)) > pxDefinition->ulTimeBudget))
+        {
+            xReturn = pdTRUE;
+
+            /* Count the overrun once per call, however often it is checked. */
+            if (xCallOverrun == pdFALSE)
+            {
+                xCallOverrun = pdTRUE;
+                pxExecutingCommand->xStats.ulOverruns++;
+            }
+
+            if ((pxDefinition->ucFlags & cliCOMMAND_FLAG_COOPERATIVE) != 0U)
+            {
+                /* Time spent blocked is not charged to the command. */
+                prvAccumulateCallTime();
+                vTaskDelay(1);
+                ulCallStartTime = configCOMMAND_INT_GET_TIME();
+            }
+        }
+    }
+
+    return xReturn;
+}
+
+#else
+
+BaseType_t FreeRTOS_CLIYieldCheck(void)
+{
+    return pdFALSE;
+}
+
+#endif /* configCOMMAND_INT_USE_STATS */
+/*-----------------------------------------------------------*/
+
+#if (configCOMMAND_INT_USE_STATS == 1)
+
+static void prvAccumulateCallTime(void)
+{
+    uint32_t ulNow = configCOMMAND_INT_GET_TIME();
+
+    ulCallRunTime += ulNow - ulCallStartTime;
+    ulCallStartTime = ulNow;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvStatsCommand(char *pcWriteBuffer,
+                                  size_t xWriteBufferLen,
+                                  const char *pcCommandString)
+{
+    CLI_Command_Context_t *pxContext = FreeRTOS_CLIGetContext();
+    const CLI_Definition_List_Item_t *pxCommand;
+    const CLI_Command_Stats_t *pxStats;
+    uint32_t ulAverage;
+    CLI_Record_t xRecord;
+
+    (void)pcCommandString;
+
+    if (pxContext->pvCursor == NULL)
+    {
+        pxContext->pvCursor = &xRegisteredCommands;
+    }
+
+    /* The stats command itself is still running, so its own call count is
+     * reported but its timing is only complete once it returns. */
+    pxCommand = (const CLI_Definition_List_Item_t *)pxContext->pvCursor;
+    pxStats = &pxCommand->xStats;
+    ulAverage = (pxStats->ulInvocations != 0U) ? (pxStats->ulTotalTime / pxStats->ulInvocations) : 0U;
+
+    /* One record per command; a record that cannot fit the buffer is dropped. */
+    FreeRTOS_CLIRecordInit(&xRecord, pcWriteBuffer, xWriteBufferLen);
+    FreeRTOS_CLIRecordBegin(&xRecord);
+    FreeRTOS_CLIRecordString(&xRecord, "command", pxCommand->pxCommandLineDefinition->pcCommand);
+    FreeRTOS_CLIRecordUnsigned(&xRecord, "calls", pxStats->ulInvocations);
+    FreeRTOS_CLIRecordUnsigned(&xRecord, "avg", ulAverage);
+    FreeRTOS_CLIRecordUnsigned(&xRecord, "max", pxStats->ulMaxTime);
+    FreeRTOS_CLIRecordUnsigned(&xRecord, "budget", pxCommand->pxCommandLineDefinition->ulTimeBudget);
+    FreeRTOS_CLIRecordUnsigned(&xRecord, "overruns", pxStats->ulOverruns);
+    FreeRTOS_CLIRecordUnsigned(&xRecord, "stack", pxStats->usStackUsed);
+    FreeRTOS_CLIRecordUnsigned(&xRecord, "stack_size", pxCommand->pxCommandLineDefinition->usStackDepth);
+    FreeRTOS_CLIRecordUnsigned(&xRecord, "arena", pxStats->usArenaPeak);
+    (void)FreeRTOS_CLIRecordEnd(&xRecord);
+
+    pxContext->pvCursor = pxCommand->pxNext;
+
+    return (pxContext->pvCursor == NULL) ? pdFALSE : pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configCOMMAND_INT_USE_STATS */
+
+static void prvCompleteCommand(CLI_Command_Context_t *pxContext)
+{
+#if (configCOMMAND_INT_USE_STATS == 1)
+    if ((pxContext->pxCommand != NULL) &&
+        (pxContext->xArenaUsed > pxContext->pxCommand->xStats.usArenaPeak))
     {
-        /* Reset the pxCommand pointer back to the start of the list. */
-        pxCommand = &xRegisteredCommands;
+        pxContext->pxCommand->xStats.usArenaPeak = (uint16_t)pxContext->xArenaUsed;
     }
+#endif
 
-    /* Return the next command help string, before moving the pointer on to
-     * the next command in the list. */
-    strncpy(pcWriteBuffer, pxCommand->pxCommandLineDefinition->pcHelpString, xWriteBufferLen);
-    pxCommand = pxCommand->pxNext;
+    /* Bump allocation only ever grows, so the bytes in use at the end of the
+     * command are its peak, and releasing them all is a single store. */
+    pxContext->xArenaUsed = 0U;
+    pxContext->pxCommand = NULL;
+    pxContext->uxResumePoint = 0U;
+    pxContext->pvCursor = NULL;
+    pxContext->uxIndex = 0U;
+}
+/*-----------------------------------------------------------*/
+
+static CLI_Definition_List_Item_t *prvFindCommand(const char *const pcCommandInput,
+                                                  UBaseType_t *puxMatches)
+{
+    CLI_Definition_List_Item_t *pxCommand;
+    CLI_Definition_List_Item_t *pxAbbreviated = NULL;
+    CLI_Definition_List_Item_t *pxUnknown = NULL;
+    const char *pcRegisteredCommandString;
+    size_t xInputLength = strcspn(pcCommandInput, " ");
+    UBaseType_t uxPrefixes = 0U;
+    UBaseType_t uxMatch;
+
+    /* One pass over the list: a whole name ends the search as it always did,
+     * abbreviations are only counted on the way, so tolerant matching walks
+     * the list no further than an unknown command already does. */
+    for (pxCommand = &xRegisteredCommands; pxCommand != NULL; pxCommand = pxCommand->pxNext)
+    {
+        pcRegisteredCommandString = pxCommand->pxCommandLineDefinition->pcCommand;
+
+        /* A stub for unknown names only matches if nothing else does. */
+        if ((pxCommand->pxCommandLineDefinition->ucFlags & cliCOMMAND_FLAG_UNKNOWN) != 0U)
+        {
+            pxUnknown = (pxUnknown == NULL) ? pxCommand : pxUnknown;
+            continue;
+        }
+
+        /* A group stub, or a command with several names, matches any of its names. */
+        if ((pxCommand->pxCommandLineDefinition->ucFlags & (cliCOMMAND_FLAG_GROUP | cliCOMMAND_FLAG_NAMES)) != 0U)
+        {
+            uxMatch = prvMatchNames(pcRegisteredCommandString, pcCommandInput, &uxPrefixes);
+        }
+        else
+        {
+            uxMatch = prvMatchName(pcRegisteredCommandString, strlen(pcRegisteredCommandString), pcCommandInput, xInputLength);
+            uxPrefixes += (uxMatch == cliMATCH_PREFIX) ? 1U : 0U;
+        }
+
+        if (uxMatch == cliMATCH_EXACT)
+        {
+            uxPrefixes = 1U;
+            break;
+        }
+
+        if ((uxMatch == cliMATCH_PREFIX) && (pxAbbreviated == NULL))
+        {
+            pxAbbreviated = pxCommand;
+        }
+    }
 
     if (pxCommand == NULL)
     {
-        /* There are no more commands in the list, so there will be no more
-         *  strings to return after this one and pdFALSE should be returned. */
-        xReturn = pdFALSE;
+        pxCommand = (uxPrefixes == 1U) ? pxAbbreviated : NULL;
     }
-    else
+
+    /* An empty line names no command, it must not load the groups behind the stub. */
+    if ((pxCommand == NULL) &&
+        (uxPrefixes == 0U) &&
+        (xInputLength > 0U))
+    {
+        pxCommand = pxUnknown;
+    }
+
+    if (puxMatches != NULL)
+    {
+        *puxMatches = uxPrefixes;
+    }
+
+    return pxCommand;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvMatchName(const char *pcName,
+                                size_t xNameLength,
+                                const char *const pcCommandInput,
+                                size_t xInputLength)
+{
+    size_t x;
+
+    for (x = 0; x < xNameLength; x++)
+    {
+        if (cliFOLD(pcCommandInput[x]) != cliFOLD(pcName[x]))
+        {
+            break;
+        }
+    }
+
+    /* To ensure the string lengths match exactly, so as not to pick up
+     * a sub-string of a longer command, check the byte after the expected
+     * end of the string is either the end of the string or a space before
+     * a parameter. */
+    if (x == xNameLength)
+    {
+        return ((pcCommandInput[x] == ' ') || (pcCommandInput[x] == 0x00)) ? cliMATCH_EXACT : cliMATCH_NONE;
+    }
+
+#if (configCOMMAND_INT_ABBREVIATIONS == 1)
+    /* The first word ended inside the name. */
+    if ((x == xInputLength) && (x != 0U))
+    {
+        return cliMATCH_PREFIX;
+    }
+#else
+    (void)xInputLength;
+#endif
+
+    return cliMATCH_NONE;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvMatchNames(const char *pcNames,
+                                 const char *const pcCommandInput,
+                                 UBaseType_t *puxPrefixes)
+{
+    size_t xInputLength = strcspn(pcCommandInput, " ");
+    size_t xNameLength;
+    UBaseType_t uxBest = cliMATCH_NONE;
+    UBaseType_t uxMatch;
+
+    while (*pcNames != 0x00)
+    {
+        xNameLength = strcspn(pcNames, " ");
+        uxMatch = prvMatchName(pcNames, xNameLength, pcCommandInput, xInputLength);
+
+        if (uxMatch == cliMATCH_EXACT)
+        {
+            return cliMATCH_EXACT;
+        }
+
+        if (uxMatch == cliMATCH_PREFIX)
+        {
+            uxBest = cliMATCH_PREFIX;
+
+            if (puxPrefixes != NULL)
+            {
+                (*puxPrefixes)++;
+            }
+        }
+
+        /* Move on to the next name. */
+        pcNames += xNameLength;
+
+        while (*pcNames == ' ')
+        {
+            pcNames++;
+        }
+    }
+
+    return uxBest;
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteAmbiguity(const char *const pcCommandInput,
+                              char *pcWriteBuffer,
+                              size_t xWriteBufferLen)
+{
+    const CLI_Definition_List_Item_t *pxCommand;
+    const char *pcNames;
+    size_t xInputLength = strcspn(pcCommandInput, " ");
+    size_t xNameLength;
+    size_t xLength;
+
+    if ((pxCurrentContext->ucFormat != cliFORMAT_TEXT) ||
+        (pxCurrentContext->ucVerbosity != cliVERBOSITY_HUMAN) ||
+        (xWriteBufferLen < sizeof("\r\n")))
+    {
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_AMBIGUOUS, NULL);
+        return;
+    }
+
+    /* Keep room for the line end. */
+    xWriteBufferLen -= sizeof("\r\n") - 1U;
+    xLength = (size_t)snprintf(pcWriteBuffer, xWriteBufferLen, "Ambiguous command, could be:");
+
+    for (pxCommand = &xRegisteredCommands; pxCommand != NULL; pxCommand = pxCommand->pxNext)
     {
-        xReturn = pdTRUE;
+        pcNames = pxCommand->pxCommandLineDefinition->pcCommand;
+
+        while ((*pcNames != 0x00) && (xLength < xWriteBufferLen))
+        {
+            /* Only group stubs and commands with several names hold a list of names. */
+            xNameLength = ((pxCommand->pxCommandLineDefinition->ucFlags & (cliCOMMAND_FLAG_GROUP | cliCOMMAND_FLAG_NAMES)) != 0U) ? strcspn(pcNames, " ") : strlen(pcNames);
+
+            if (prvMatchName(pcNames, xNameLength, pcCommandInput, xInputLength) == cliMATCH_PREFIX)
+            {
+                xLength += (size_t)snprintf(&pcWriteBuffer[xLength], xWriteBufferLen - xLength, " %.*s", (int)xNameLength, pcNames);
+            }
+
+            pcNames += xNameLength;
+
+            while (*pcNames == ' ')
+            {
+                pcNames++;
+            }
+        }
+    }
+
+    xLength = (xLength < xWriteBufferLen) ? xLength : (xWriteBufferLen - 1U);
+    strcpy(&pcWriteBuffer[xLength], "\r\n");
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvLoadGroup(CLI_Definition_List_Item_t *pxStub,
+                               char *pcWriteBuffer,
+                               size_t xWriteBufferLen,
+                               const char *const pcCommandInput)
+{
+    CLI_Definition_List_Item_t *pxPrevious;
+    BaseType_t xReturn;
+
+    xReturn = pxStub->pxCommandLineDefinition->pxCommandInterpreter(pcWriteBuffer, xWriteBufferLen, pcCommandInput);
+
+    if (xReturn == pdPASS)
+    {
+        taskENTER_CRITICAL();
+        {
+            /* The help command is always first, so the stub has a predecessor. */
+            for (pxPrevious = &xRegisteredCommands; pxPrevious->pxNext != pxStub; pxPrevious = pxPrevious->pxNext)
+            {
+            }
+
+            pxPrevious->pxNext = pxStub->pxNext;
+
+            if (pxLastCommandInList == pxStub)
+            {
+                pxLastCommandInList = pxPrevious;
+            }
+        }
+        taskEXIT_CRITICAL();
     }
 
     return xReturn;
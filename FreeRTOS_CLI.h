@@ -34,6 +34,101 @@ extern "C"
 #endif
     /* *INDENT-ON* */
 
+/* Per-command execution statistics are collected by the command interpreter
+ * unless configCOMMAND_INT_USE_STATS is set to 0 in FreeRTOSConfig.h. */
+#ifndef configCOMMAND_INT_USE_STATS
+#define configCOMMAND_INT_USE_STATS 1
+#endif
+
+/* The "cli-schema" built-in command, which lists the interface of every
+ * registered command for host tooling, is included unless
+ * configCOMMAND_INT_USE_SCHEMA is set to 0 in FreeRTOSConfig.h. */
+#ifndef configCOMMAND_INT_USE_SCHEMA
+#define configCOMMAND_INT_USE_SCHEMA 1
+#endif
+
+/* Command names are matched regardless of the case of the input when
+ * configCOMMAND_INT_FOLD_CASE is set to 1 in FreeRTOSConfig.h, so "Version"
+ * runs "version". */
+#ifndef configCOMMAND_INT_FOLD_CASE
+#define configCOMMAND_INT_FOLD_CASE 0
+#endif
+
+/* A command can be entered as any abbreviation of its name that no other
+ * command name starts with when configCOMMAND_INT_ABBREVIATIONS is set to 1 in
+ * FreeRTOSConfig.h, so "ver" runs "version".  A name typed in full always runs
+ * that command, even if it also abbreviates a longer one. */
+#ifndef configCOMMAND_INT_ABBREVIATIONS
+#define configCOMMAND_INT_ABBREVIATIONS 0
+#endif
+
+/* How the first word of the input matches a command name, see
+ * FreeRTOS_CLIMatchName(). */
+#define cliMATCH_NONE 0   /* The word is not the name. */
+#define cliMATCH_PREFIX 1 /* The word abbreviates the name. */
+#define cliMATCH_EXACT 2  /* The word is the name. */
+
+/* Version of the layout of the "cli-schema" records.  Changed whenever a field
+ * is removed or changes meaning; fields are only ever appended otherwise. */
+#define cliSCHEMA_VERSION 1
+
+/* The time source used to measure command execution.  Defaults to the tick
+ * count; it can be mapped onto a cycle counter (for example DWT->CYCCNT) in
+ * FreeRTOSConfig.h when finer resolution is needed.  Command time budgets are
+ * expressed in the same units. */
+#ifndef configCOMMAND_INT_GET_TIME
+#define configCOMMAND_INT_GET_TIME() ((uint32_t)xTaskGetTickCount())
+#endif
+
+/* Exit status of the last command executed in a context, returned by
+ * FreeRTOS_CLIGetStatus().  Values from cliSTATUS_FAILED upwards are set by
+ * command callbacks through FreeRTOS_CLISetStatus(). */
+#define cliSTATUS_OK 0
+#define cliSTATUS_NOT_FOUND 1      /* No registered command matched the input. */
+#define cliSTATUS_BAD_PARAMETERS 2 /* The command was given the wrong number of parameters. */
+#define cliSTATUS_FAILED 3         /* The command ran but reported a failure. */
+
+/* Verbosity of the messages written in a context, see FreeRTOS_CLISetVerbosity(). */
+#define cliVERBOSITY_HUMAN 0 /* Full sentences, the default. */
+#define cliVERBOSITY_TERSE 1 /* Short coded messages such as "E02 argc", for scripted clients. */
+
+/* Width of the first column of a record rendered as text. */
+#ifndef configCOMMAND_INT_RECORD_NAME_WIDTH
+#define configCOMMAND_INT_RECORD_NAME_WIDTH 16
+#endif
+
+/* Format of the records written in a context, see FreeRTOS_CLISetFormat(). */
+#define cliFORMAT_TEXT 0 /* One aligned line per record, the default. */
+#define cliFORMAT_JSON 1 /* One JSON object per line. */
+#define cliFORMAT_CBOR 2 /* One CBOR map per record, as a CBOR sequence. */
+
+/* Errors written with FreeRTOS_CLIWriteError().  In terse mode an error is
+ * written as "E" followed by its two digit number and a short tag. */
+#define cliERROR_FAILED 0           /* E00 err - The command failed. */
+#define cliERROR_UNKNOWN_COMMAND 1  /* E01 cmd - No registered command matched the input. */
+#define cliERROR_PARAMETER_COUNT 2  /* E02 argc - Wrong number of parameters. */
+#define cliERROR_INVALID_ARGUMENT 3 /* E03 arg - A parameter has an invalid value. */
+#define cliERROR_NOT_FOUND 4        /* E04 none - The object named by a parameter does not exist. */
+#define cliERROR_PENDING_FULL 5     /* E05 pend - Too many uncommitted changes. */
+#define cliERROR_FULL 6             /* E06 full - No storage left. */
+#define cliERROR_FLASH 7            /* E07 flash - A flash operation failed. */
+#define cliERROR_UNAVAILABLE 8      /* E08 load - The command could not be loaded. */
+#define cliERROR_NESTED 9           /* E09 nest - A script tried to execute a script. */
+#define cliERROR_AMBIGUOUS 10       /* E10 ambig - The input abbreviates more than one command name. */
+
+/* Values for the ucFlags member of CLI_Command_Definition_t. */
+#define cliCOMMAND_FLAG_NONE 0x00U
+#define cliCOMMAND_FLAG_COOPERATIVE 0x01U /* FreeRTOS_CLIYieldCheck() blocks for a tick once the time budget is exceeded. */
+#define cliCOMMAND_FLAG_GROUP 0x02U       /* The definition is the stub of a command group, see FreeRTOS_CLIRegisterCommand(). */
+#define cliCOMMAND_FLAG_NAMES 0x04U       /* pcCommand is a list of space separated names, any of which runs the command. */
+#define cliCOMMAND_FLAG_UNKNOWN 0x08U     /* With cliCOMMAND_FLAG_GROUP, the stub stands for any name no registered command matches. */
+
+/* Values for the ucNesting member of CLI_Command_Context_t.  A command that runs
+ * other commands in a nested context copies the flags of its own context into
+ * the nested one, adding its own if the commands it runs must know about it. */
+#define cliNESTING_NONE 0x00U
+#define cliNESTING_SCRIPT 0x01U /* The context runs the commands of a script, directly or further nested. */
+
     /* The prototype to which callback functions used to process command line
      * commands must comply.  pcWriteBuffer is a buffer into which the output from
      * executing the command can be written, xWriteBufferLen is the length, in bytes of
@@ -47,27 +142,141 @@ extern "C"
      * should be defined by declaring a const structure of this type. */
     typedef struct xCOMMAND_LINE_INPUT
     {
-        const char *const pcCommand;                        /* The command that causes pxCommandInterpreter to be executed.  For example "help".  Must be all lower case. */
+        const char *const pcCommand;                        /* The command that causes pxCommandInterpreter to be executed.  For example "help".  Must be all lower case, the input is folded to match it when configCOMMAND_INT_FOLD_CASE is 1. */
         const char *const pcHelpString;                     /* String that describes how to use the command.  Should start with the command itself, and end with "\r\n".  For example "help: Returns a list of all the commands\r\n". */
         const pdCOMMAND_LINE_CALLBACK pxCommandInterpreter; /* A pointer to the callback function that will return the output generated by the command. */
         int8_t cExpectedNumberOfParameters;                 /* Commands expect a fixed number of parameters, which may be zero. */
+        uint32_t ulTimeBudget;                              /* Longest time a single call of pxCommandInterpreter is expected to run, in configCOMMAND_INT_GET_TIME() units.  Zero means no budget. */
+        uint8_t ucFlags;                                    /* A bitwise OR of cliCOMMAND_FLAG_xxx values. */
+        uint16_t usStackDepth;                              /* Stack, in words, the task running pxCommandInterpreter needs.  Zero means the smallest the console provides. */
     } CLI_Command_Definition_t;
 
+#if (configCOMMAND_INT_USE_STATS == 1)
+    /* Execution statistics kept for each registered command. */
+    typedef struct xCOMMAND_STATS
+    {
+        uint32_t ulInvocations; /* Number of times the command has been entered. */
+        uint32_t ulTotalTime;   /* Accumulated run time of all calls to the callback. */
+        uint32_t ulMaxTime;     /* Longest single call to the callback. */
+        uint32_t ulOverruns;    /* Number of calls that exceeded ulTimeBudget. */
+        uint16_t usStackUsed;   /* Deepest stack, in words, seen by the console in the task that ran the command. */
+        uint16_t usArenaPeak;   /* Most scratch arena memory, in bytes, one invocation has allocated. */
+    } CLI_Command_Stats_t;
+#endif
+
     /* The structure that defines a command line list entry. */
     typedef struct xCOMMAND_INPUT_LIST
     {
         const CLI_Command_Definition_t *pxCommandLineDefinition;
         struct xCOMMAND_INPUT_LIST *pxNext;
+#if (configCOMMAND_INT_USE_STATS == 1)
+        CLI_Command_Stats_t xStats;
+#endif
     } CLI_Definition_List_Item_t;
 
+    /* The state of the command a console is executing.  Each console (session)
+     * owns one of these and binds it with FreeRTOS_CLISetContext() before calling
+     * FreeRTOS_CLIProcessCommand(), so the continuation of a multi-call command
+     * lives with the console rather than in static variables.  The interpreter
+     * clears the per-command members each time a new command is entered.
+     *
+     * A context may also own a scratch arena, set up with
+     * FreeRTOS_CLIInitContext(), from which callbacks allocate temporary memory
+     * with FreeRTOS_CLIArenaAlloc().  Everything allocated from the arena is
+     * released in one go when the command completes or is aborted, so there is
+     * nothing for a callback to free on its error paths. */
+    typedef struct xCOMMAND_CONTEXT
+    {
+        struct xCOMMAND_INPUT_LIST *pxCommand; /* The command in progress, NULL when the interpreter is waiting for a new command. */
+        UBaseType_t uxResumePoint;             /* Where a cliCOROUTINE_ callback continues on its next call.  Zero on the first call. */
+        void *pvCursor;                        /* General purpose state a callback keeps between calls. */
+        UBaseType_t uxIndex;                   /* General purpose state a callback keeps between calls. */
+        uint8_t *pucArena;                     /* Scratch arena memory, NULL if the console provides none. */
+        size_t xArenaSize;                     /* Size of the scratch arena in bytes. */
+        size_t xArenaUsed;                     /* Bytes allocated from the arena by the command in progress. */
+        BaseType_t xStatus;                    /* Exit status of the command in progress or last executed, a cliSTATUS_xxx value. */
+        uint8_t ucVerbosity;                   /* A cliVERBOSITY_xxx value, kept across commands. */
+        uint8_t ucFormat;                      /* A cliFORMAT_xxx value, kept across commands. */
+        uint8_t ucNesting;                     /* cliNESTING_xxx flags of the commands this context is nested in, kept across commands. */
+        size_t xOutputLength;                  /* Length of the binary output of the last call, zero if the output is a string. */
+#if (configCOMMAND_INT_USE_STATS == 1)
+        uint32_t ulLookupTime;                 /* Time the command in progress or last executed took to find, group loading included. */
+        uint32_t ulParseTime;                  /* Time its parameters took to check. */
+        uint32_t ulExecuteTime;                /* Time spent in its callback, over all the calls so far. */
+#endif
+    } CLI_Command_Context_t;
+
+    /* A record being written by a command callback with the
+     * FreeRTOS_CLIRecord functions.  Declared on the callback's stack. */
+    typedef struct xCLI_RECORD
+    {
+        char *pcBuffer;     /* The output buffer of the callback. */
+        size_t xBufferLen;  /* Size of the output buffer. */
+        size_t xLength;     /* Bytes written to the output buffer so far. */
+        size_t xStart;      /* Offset of the record in progress. */
+        uint8_t ucFormat;   /* Format the record is written in, a cliFORMAT_xxx value. */
+        uint8_t ucFields;   /* Number of fields of the record in progress. */
+        BaseType_t xFull;   /* The record in progress did not fit. */
+    } CLI_Record_t;
+
 /* For backward compatibility. */
 #define xCommandLineInput CLI_Command_Definition_t
 
+/*
+ * Stackless coroutine helpers for callbacks that produce their output over
+ * several calls.  Rather than returning pdTRUE and working out where it was on
+ * the next call, a callback written as:
+ *
+ *  CLI_Command_Context_t *pxContext = FreeRTOS_CLIGetContext();
+ *  cliCOROUTINE_BEGIN( pxContext );
+ *  for( pxContext->uxIndex = 0; pxContext->uxIndex < 10; pxContext->uxIndex++ )
+ *  {
+ *      ... write one line to pcWriteBuffer ...
+ *      cliCOROUTINE_YIELD( pxContext );
+ *  }
+ *  cliCOROUTINE_END( pxContext );
+ *
+ * returns each chunk with pdTRUE and resumes after the yield when called again.
+ * Local variables are not preserved across a yield; anything that must survive
+ * is kept in the context.  A coroutine must not yield from inside a switch
+ * statement of its own.
+ */
+#define cliCOROUTINE_BEGIN(pxContext) \
+    switch ((pxContext)->uxResumePoint) \
+    {                                   \
+    case 0:
+
+#define cliCOROUTINE_YIELD(pxContext)                            \
+    do                                                           \
+    {                                                            \
+        (pxContext)->uxResumePoint = (UBaseType_t)__LINE__;      \
+        return pdTRUE;                                           \
+    case __LINE__:;                                              \
+    } while (0)
+
+#define cliCOROUTINE_END(pxContext)  \
+    }                                \
+    (pxContext)->uxResumePoint = 0;  \
+    return pdFALSE
+
 /*
  * Register the command passed in using the pxCommandToRegister parameter.
  * Registering a command adds the command to the list of commands that are
  * handled by the command interpreter.  Once a command has been registered it
  * can be executed from the command line.
+ *
+ * A definition with cliCOMMAND_FLAG_GROUP set registers a stub standing for a
+ * whole group of commands that are only registered when first used.  Its
+ * pcCommand lists the names of the group's commands separated by spaces, and
+ * its pcHelpString is listed by help until the group is loaded.  The first
+ * time one of the names is entered, pxCommandInterpreter is called once to
+ * load the group: it registers the group's commands, initialises whatever
+ * they need and returns pdPASS, or writes an error message to pcWriteBuffer
+ * and returns pdFAIL.  The stub is then removed and the command that was
+ * entered runs as usual.  usStackDepth should be the largest of the group.
+ * With cliCOMMAND_FLAG_UNKNOWN also set, the stub has no names and is loaded
+ * by the first name that no registered command matches, for a group whose
+ * names are only known once it is loaded.
  */
 #if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
     BaseType_t FreeRTOS_CLIRegisterCommand(const CLI_Command_Definition_t *const pxCommandToRegister);
@@ -91,12 +300,36 @@ extern "C"
      * FreeRTOS_CLIProcessCommand should be called repeatedly until it returns pdFALSE.
      *
      * pcCmdIntProcessCommand is not reentrant.  It must not be called from more
-     * than one task - or at least - by more than one task at a time.
+     * than one task - or at least - by more than one task at a time.  A command
+     * callback may however run another command to completion, provided it binds
+     * a context of its own for it and restores its own context afterwards.
      */
     BaseType_t FreeRTOS_CLIProcessCommand(const char *const pcCommandInput,
                                           char *pcWriteBuffer,
                                           size_t xWriteBufferLen);
 
+    /*
+     * As FreeRTOS_CLIProcessCommand(), for a command already resolved with
+     * FreeRTOS_CLIResolveCommand().  The command is neither looked up nor are
+     * its parameters counted: the caller guarantees pcCommandInput runs
+     * pxResolvedCommand with the number of parameters it expects.
+     */
+    BaseType_t FreeRTOS_CLIProcessResolvedCommand(CLI_Definition_List_Item_t *pxResolvedCommand,
+                                                  const char *const pcCommandInput,
+                                                  char *pcWriteBuffer,
+                                                  size_t xWriteBufferLen);
+
+    /*
+     * Return the list item of the registered command that pcCommandInput runs,
+     * loading its command group first if it has not been used yet.  Returns
+     * NULL if no command matches, or if the group could not be loaded, in which
+     * case the loader's error message is in pcWriteBuffer.  List items are
+     * never freed, so the item can be kept and run any number of times.
+     */
+    CLI_Definition_List_Item_t *FreeRTOS_CLIResolveCommand(const char *const pcCommandInput,
+                                                           char *pcWriteBuffer,
+                                                           size_t xWriteBufferLen);
+
     /*-----------------------------------------------------------*/
 
     /*
@@ -119,6 +352,170 @@ extern "C"
                                          UBaseType_t uxWantedParameter,
                                          BaseType_t *pxParameterStringLength);
 
+    /*
+     * Return the list item of the registered command that pcCommandInput would
+     * run, or NULL if no registered command matches.  The parameters that follow
+     * the command name are not checked.
+     */
+    CLI_Definition_List_Item_t *FreeRTOS_CLIFindCommand(const char *const pcCommandInput);
+
+    /*
+     * Return how the first word of pcCommandInput matches the best of the
+     * space separated names in pcNames, as one of the cliMATCH_xxx values, by
+     * the rules the interpreter finds commands with.  Lets a callback that
+     * serves several names tell which one was entered.
+     */
+    UBaseType_t FreeRTOS_CLIMatchName(const char *pcNames,
+                                      const char *const pcCommandInput);
+
+    /*
+     * Iterate over the registered commands.  Passing NULL returns the first
+     * command in the list, passing a list item returns the one that follows it.
+     * NULL is returned after the last command.
+     */
+    CLI_Definition_List_Item_t *FreeRTOS_CLIGetNextCommand(const CLI_Definition_List_Item_t *pxItem);
+
+    /*
+     * Prepare a console's command context for use, giving it xArenaSize bytes
+     * at pvArena as scratch arena.  pvArena may be NULL if the console provides
+     * no arena.
+     */
+    void FreeRTOS_CLIInitContext(CLI_Command_Context_t *pxContext,
+                                 void *pvArena,
+                                 size_t xArenaSize);
+
+    /*
+     * Abandon the command in progress in the bound context, for example when
+     * its output can no longer be delivered.  The next call to
+     * FreeRTOS_CLIProcessCommand() then starts a new command, and the arena is
+     * released as if the command had completed.
+     */
+    void FreeRTOS_CLIAbortCommand(void);
+
+    /*
+     * Set or return the exit status of the command executing in the bound
+     * context.  A command's status is cliSTATUS_OK unless its callback sets
+     * another value; it remains readable after the command has completed, until
+     * the next command is entered.  Used for example to stop a script at the
+     * first command that fails.
+     */
+    void FreeRTOS_CLISetStatus(BaseType_t xStatus);
+    BaseType_t FreeRTOS_CLIGetStatus(void);
+
+    /*
+     * Set or return the verbosity of the bound context, a cliVERBOSITY_xxx
+     * value.  Unlike the other members of the context it is kept from one
+     * command to the next, so it is a setting of the console session.
+     */
+    void FreeRTOS_CLISetVerbosity(uint8_t ucVerbosity);
+    uint8_t FreeRTOS_CLIGetVerbosity(void);
+
+    /*
+     * Set or return the format of the records written in the bound context, a
+     * cliFORMAT_xxx value.  Kept from one command to the next, like the
+     * verbosity.
+     */
+    void FreeRTOS_CLISetFormat(uint8_t ucFormat);
+    uint8_t FreeRTOS_CLIGetFormat(void);
+
+    /*
+     * Return the number of bytes of output the last call of
+     * FreeRTOS_CLIProcessCommand() wrote into pcWriteBuffer.  Output written
+     * with the FreeRTOS_CLIRecord functions may be binary, so the console must
+     * use this rather than strlen() to send it.
+     */
+    size_t FreeRTOS_CLIGetOutputLength(const char *pcWriteBuffer);
+
+    /*
+     * Streaming encoder for command output.  A callback describes its output as
+     * records of key/value fields, and the fields are rendered in the format of
+     * the bound context as they are added, straight into pcWriteBuffer:
+     *
+     *  CLI_Record_t xRecord;
+     *  FreeRTOS_CLIRecordInit( &xRecord, pcWriteBuffer, xWriteBufferLen );
+     *  while( there are items )
+     *  {
+     *      FreeRTOS_CLIRecordBegin( &xRecord );
+     *      FreeRTOS_CLIRecordString( &xRecord, "name", pcName );
+     *      FreeRTOS_CLIRecordUnsigned( &xRecord, "size", ulSize );
+     *      if( FreeRTOS_CLIRecordEnd( &xRecord ) != pdPASS )
+     *      {
+     *          return pdTRUE; // Send this chunk, retry the item on the next call.
+     *      }
+     *  }
+     *
+     * Nothing larger than one record is ever held in RAM.  As text, a record is
+     * one line: the value of its first field in a column of
+     * configCOMMAND_INT_RECORD_NAME_WIDTH characters, then "key=value" for the
+     * other fields.  As JSON, it is one object per line.  As CBOR, it is a map of
+     * at most 23 fields with text keys.
+     *
+     * FreeRTOS_CLIRecordEnd() returns pdFAIL if the record did not fit in what
+     * was left of the buffer; the record is then removed from the buffer.  If
+     * FreeRTOS_CLIRecordLength() is zero at that point, the record does not fit
+     * even in an empty buffer and must be skipped.
+     */
+    void FreeRTOS_CLIRecordInit(CLI_Record_t *pxRecord,
+                                char *pcWriteBuffer,
+                                size_t xWriteBufferLen);
+    void FreeRTOS_CLIRecordBegin(CLI_Record_t *pxRecord);
+    void FreeRTOS_CLIRecordString(CLI_Record_t *pxRecord,
+                                  const char *pcKey,
+                                  const char *pcValue);
+    void FreeRTOS_CLIRecordUnsigned(CLI_Record_t *pxRecord,
+                                    const char *pcKey,
+                                    uint32_t ulValue);
+    void FreeRTOS_CLIRecordSigned(CLI_Record_t *pxRecord,
+                                  const char *pcKey,
+                                  int32_t lValue);
+    BaseType_t FreeRTOS_CLIRecordEnd(CLI_Record_t *pxRecord);
+    size_t FreeRTOS_CLIRecordLength(const CLI_Record_t *pxRecord);
+
+    /*
+     * Write the message of error uxError (a cliERROR_xxx value) into
+     * pcWriteBuffer, according to the verbosity of the bound context.  In terse
+     * mode the coded form, such as "E02 argc", is always written.  In human mode
+     * pcHumanMessage is written if it is not NULL, otherwise the error's
+     * sentence from the shared table.  If the format of the context is JSON
+     * or CBOR, the error is written as a record with "error" and "tag" fields
+     * instead, so that it can be decoded like the rest of the output.
+     */
+    void FreeRTOS_CLIWriteError(char *pcWriteBuffer,
+                                size_t xWriteBufferLen,
+                                UBaseType_t uxError,
+                                const char *pcHumanMessage);
+
+    /*
+     * Allocate xSize bytes from the arena of the bound context.  The memory
+     * stays valid until the command that allocated it completes or is aborted,
+     * including across calls of a multi-call command.  Returns NULL if the arena
+     * cannot satisfy the request.
+     */
+    void *FreeRTOS_CLIArenaAlloc(size_t xSize);
+
+    /*
+     * Bind the command context FreeRTOS_CLIProcessCommand() works on.  A console
+     * calls this before processing input; passing NULL restores the interpreter's
+     * own context, which is also used if this function is never called.
+     */
+    void FreeRTOS_CLISetContext(CLI_Command_Context_t *pxContext);
+
+    /*
+     * Return the context bound by FreeRTOS_CLISetContext().  Intended for use by
+     * command callbacks, in particular with the cliCOROUTINE_ macros.
+     */
+    CLI_Command_Context_t *FreeRTOS_CLIGetContext(void);
+
+    /*
+     * Called by long running command callbacks from inside their loops.  If the
+     * current call to the callback has run for longer than the command's
+     * ulTimeBudget the overrun is recorded and, for commands registered with
+     * cliCOMMAND_FLAG_COOPERATIVE, the calling task blocks for one tick so lower
+     * priority tasks get to run before the callback continues.  Returns pdTRUE
+     * if the budget had been exceeded, otherwise pdFALSE.
+     */
+    BaseType_t FreeRTOS_CLIYieldCheck(void);
+
 /* *INDENT-OFF* */
 #ifdef __cplusplus
 }
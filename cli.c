@@ -20,17 +20,28 @@
 
 #include "cli.h"
 #include "cli_cmd.h"
+#include "cli_script.h"
+#include "cli_capture.h"
+#include "cli_job.h"
 #include <stdio.h>
 #include <string.h>
 
 //======================================================================[ INTERNAL MACRO DEFENITIONS ]===================================================================================== //
 
+#ifdef CLI_GET_TIME_US
+#define CLI_TURNAROUND_START() CLI_GET_TIME_US() // Time the turnaround is measured from
+#else
+#define CLI_TURNAROUND_START() 0U                // The turnaround histogram is disabled
+#endif
+
 //======================================================================[ INTERNAL DATA TYPES DEFINITIONS ]================================================================================ //
 
 //======================================================================[ INTERNAL FUNCTIONS AND OBJECTS DECLARATION ]===================================================================== //
 
 static Cli_s cliInstance = {0}; // Instance of CLI structure to store system state
 
+static const uint16_t cliWorkerStackSizes[CLI_WORKER_COUNT] = CLI_WORKER_STACK_SIZES; // Stack of each worker class, in words
+
 /**
  * @brief CLI task that processes incoming commands.
  *
@@ -39,6 +50,170 @@ static Cli_s cliInstance = {0}; // Instance of CLI structure to store system sta
  */
 static void cliTask(void *argument);
 
+/**
+ * @brief Command worker task that executes command lines handed over by the CLI task.
+ *
+ * \param[in]  argument - Pointer to the worker's Cli_Worker_s;
+ * \param[out] none.
+ */
+static void cliWorkerTask(void *argument);
+
+/**
+ * @brief Creates the smallest worker, the larger ones replace it while they are needed.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return     int16_t - 0 on success, negative value if the worker could not be created.
+ */
+static int16_t cliCreateWorkers(void);
+
+/**
+ * @brief Creates the task of a worker.
+ *
+ * \param[in]  worker - Index of the worker;
+ * \param[out] none;
+ * \return     BaseType_t - pdPASS on success, otherwise pdFAIL.
+ */
+static BaseType_t cliCreateWorker(uint8_t worker);
+
+/**
+ * @brief Selects the smallest worker whose stack fits the requested depth, creating it in place of the existing one if needed.
+ *
+ * \param[in]  stackDepth - Stack depth required, in words;
+ * \param[out] none;
+ * \return     Cli_Worker_s* - Selected worker, NULL if the heap has no room for any worker.
+ */
+static Cli_Worker_s *cliSelectWorker(uint16_t stackDepth);
+
+/**
+ * @brief Hands a completed command line to a worker and waits until it has been executed.
+ *
+ * \param[in]  command - Command line to execute;
+ * \param[out] none;
+ * \return     none.
+ */
+static void cliDispatchCommand(const char *command);
+
+/**
+ * @brief Executes a command line and transmits its output chunk by chunk.
+ *
+ * The output is only transmitted while a session is logged in, so the boot
+ * script runs silently.
+ *
+ * \param[in]  command - Command line to execute;
+ * \param[out] none;
+ * \return     none.
+ */
+static void cliExecuteCommand(const char *command);
+
+#if (CLI_JOB_COUNT > 0)
+/**
+ * @brief Hands a due job to a worker and waits until it has been executed.
+ *
+ * \param[in]  job - Number of the job taken with CliJobTake();
+ * \param[out] none;
+ * \return     none.
+ */
+static void cliDispatchJob(int16_t job);
+
+/**
+ * @brief Executes a job and transmits the output of a console job chunk by chunk.
+ *
+ * \param[in]  job - Number of the job;
+ * \param[out] none;
+ * \return     none.
+ */
+static void cliExecuteJob(int16_t job);
+
+/**
+ * @brief Job timer callback, wakes the CLI task to run the due jobs.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return     BaseType_t - pdPASS if the wakeup was queued, pdFAIL if the RX queue is full.
+ */
+static BaseType_t cliJobWakeupCb(void);
+#endif
+
+/**
+ * @brief Strips the request ID prefix of a command line.
+ *
+ * \param[in]  line - Command line, possibly starting with "%<id> ";
+ * \param[out] none;
+ * \return     const char* - The command line without the prefix.
+ */
+static const char *cliParseRequestId(const char *line);
+
+/**
+ * @brief Transmits the end marker of a command that was prefixed with a request ID.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return     none.
+ */
+static void cliSendRequestEnd(void);
+
+/**
+ * @brief Starts the transmission of output of the CLI task.
+ *
+ * \param[in]  data    - Data to transmit;
+ * \param[in]  length  - Number of bytes to transmit;
+ * \param[in]  holdBus - If true, more output follows and the driver stays enabled;
+ * \param[out] none;
+ * \return     none.
+ */
+static void cliWrite(const uint8_t *data, uint16_t length, bool holdBus);
+
+/**
+ * @brief Releases the bus from the TX complete or error callback.
+ *
+ * \param[in]  start - Time of the TX complete interrupt, from CLI_TURNAROUND_START();
+ * \param[out] none;
+ * \return     none.
+ */
+static void cliReleaseBusFromISR(uint32_t start);
+
+/**
+ * @brief Releases the bus if the CLI task held it for output that did not come.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return     none.
+ */
+static void cliReleaseBus(void);
+
+#if (CLI_BUS_ADDRESSING == 1)
+/**
+ * @brief Address filter of the RX callback.
+ *
+ * \param[in,out] rxChar - Received character, replaced by CLI_STX_CHAR at the start of a broadcast line;
+ * \return        bool - True if the character has to be queued, false if it is dropped.
+ */
+static bool cliRxFilter(char *rxChar);
+#endif
+
+#if (CLI_FLOW_CONTROL != CLI_FLOW_NONE)
+/**
+ * @brief Asks the host to stop or to resume sending.
+ *
+ * \param[in]  throttle - If true, the host is asked to stop; otherwise, to resume;
+ * \param[out] none;
+ * \return     none.
+ */
+static void cliRxThrottle(bool throttle);
+#endif
+
+#if (CLI_FLOW_CONTROL == CLI_FLOW_XONXOFF)
+/**
+ * @brief Transmits the last flow control character requested.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return     none.
+ */
+static void cliSendFlowChar(void);
+#endif
+
 /**
  * @brief Configures UART to receive or transmit mode.
  *
@@ -76,7 +251,7 @@ static void cliTxCompletedCb(const struct usart_async_descriptor *const uart);
 static void cliRxTxErr(const struct usart_async_descriptor *const uart);
 
 /**
- * @brief Handles CLI authentication state machine.
+ * @brief Runs the authentication state machine until it has to wait for input.
  *
  * \param[in]  none;
  * \param[out] none;
@@ -85,197 +260,1075 @@ static void cliRxTxErr(const struct usart_async_descriptor *const uart);
 static void cliAuthenticate(void);
 
 /**
- * @brief Sends a message over UART and waits for completion.
+ * @brief Session timer callback, requests the logout of the inactive session.
+ *
+ * \param[in]  timer - Handle of the session timer;
+ * \param[out] none;
+ * \return     none.
+ */
+static void cliSessionTimeoutCb(TimerHandle_t timer);
+
+/**
+ * @brief Logs the session out and releases the resources it holds.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return     none.
+ */
+static void cliLogout(void);
+
+/**
+ * @brief Sends a message over UART and waits for completion.
+ *
+ * \param[in]  message - Pointer to the string to be sent;
+ * \param[out] none;
+ * \return     none.
+ */
+static void cliSendMessage(const char *message);
+
+//=======================================================================[PUBLIC INTERFACE FUNCTIONS]===================================================================================== //
+
+/**
+ * @brief Initializes the Command Line Interface (CLI).
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return int16_t - Returns 0 on successful initialization, or a negative error code on failure.
+ */
+int16_t CliStartup(void)
+{
+    int16_t status           = 0;           // A variable for storing the execution status
+    int32_t ioResult         = 0;           // A variable for storing the result
+    int32_t rxCbStatus       = ERR_NONE;    // A variable for storing the RX callback function
+    int32_t txCbStatus       = ERR_NONE;    // A variable for storing the TX callback function
+    int32_t errCbStatus      = ERR_NONE;    // A variable for storing the Error callback function
+    int32_t uartEnableStatus = ERR_NONE;    // A variable for storing the UART enable status
+
+    do
+    {
+        /* Reset UART pins to RX mode before thread creation */
+        cliSetUartDirectionMode(UART_RX_MODE);
+
+        /* Assign the UART instance to the CLI structure */
+        cliInstance.uart = &SERVICE_UART;
+
+        /* Get the I/O descriptor and store it */
+        ioResult = usart_async_get_io_descriptor(cliInstance.uart, &cliInstance.io);
+        if ((ioResult != ERR_NONE) ||
+            (cliInstance.io == NULL))
+        {
+            break;
+        }
+
+        /* Assign the index for tracking position in the receive buffer */
+        cliInstance.rxIndex = 0;
+
+#if (CLI_BUS_ADDRESSING == 1)
+        /* Listen for lines addressed to this unit */
+        cliInstance.busAddress = CLI_BUS_ADDRESS;
+        cliInstance.rxAddressState = CLI_RX_LINE_START;
+#endif
+
+        /* Clear RX and TX buffers */
+        memset(cliInstance.rxBuffer, 0, CLI_RX_BUFFER_SIZE);
+        memset(cliInstance.txBuffer, 0, CLI_TX_BUFFER_SIZE);
+
+        /* Create queues for RX and TX communication */
+        cliInstance.rxQueue = xQueueCreate(CLI_RX_QUEUE_LENGTH, sizeof(char));
+        cliInstance.txQueue = xQueueCreate(CLI_QUEUE_LENGTH, sizeof(char));
+
+        /* Check if queue creation was successful */
+        if ((!cliInstance.rxQueue) ||
+            (!cliInstance.txQueue))
+        {
+            status = -1;
+            break;
+        }
+
+        /* Initialize CLI commands by registering them with FreeRTOS CLI */
+        CliCmdInit();
+
+#if (CLI_JOB_COUNT > 0)
+        /* Jobs are due in the timer service task but run by the workers */
+        CliJobSetWakeup(cliJobWakeupCb);
+#endif
+
+        /* Create the workers in the stack classes the registered commands need */
+        if (cliCreateWorkers() != 0)
+        {
+            status = -5;
+            break;
+        }
+
+#if (CLI_SESSION_TIMEOUT_MS > 0)
+        /* Create the session timer, it only runs while a session is authenticated */
+        cliInstance.logoutPending = false;
+        cliInstance.sessionTimer = xTimerCreate("CLI_Session",
+                                                pdMS_TO_TICKS(CLI_SESSION_TIMEOUT_MS),
+                                                pdFALSE,
+                                                NULL,
+                                                cliSessionTimeoutCb);
+        if (cliInstance.sessionTimer == NULL)
+        {
+            status = -6;
+            break;
+        }
+#endif
+
+        /* Register the UART RX, TX, Err callback functions */
+        rxCbStatus = usart_async_register_callback(cliInstance.uart, USART_ASYNC_RXC_CB, cliRxReceivedCb);
+        txCbStatus = usart_async_register_callback(cliInstance.uart, USART_ASYNC_TXC_CB, cliTxCompletedCb);
+        errCbStatus = usart_async_register_callback(cliInstance.uart, USART_ASYNC_ERROR_CB, cliRxTxErr);
+
+        /* Check the success of registration of all callbacks */
+        if ((rxCbStatus != ERR_NONE) ||
+            (txCbStatus != ERR_NONE) ||
+            (errCbStatus != ERR_NONE))
+        {
+            status = -2;
+            break;
+        }
+
+        /* Enable UART communication */
+        uartEnableStatus = usart_async_enable(cliInstance.uart);
+        if (uartEnableStatus != ERR_NONE)
+        {
+            status = -3;
+            break;
+        }
+
+        /* Set UART to receive mode (RX) */
+        cliSetUartDirectionMode(UART_RX_MODE);
+
+        /* Create the CLI processing task */
+        BaseType_t taskStatus = xTaskCreate(cliTask,
+                                            "CLI_Task",
+                                            CLI_TASK_STACK_SIZE,
+                                            NULL,
+                                            CLI_TASK_PRIORITY,
+                                            &cliInstance.taskHandle);
+
+        /* Check taskStatus */
+        if (taskStatus != pdPASS)
+        {
+            status = -4;
+            break;
+        }
+
+    } while (0);
+
+    return status;
+}
+
+/**
+ * @brief Returns the number of times the CLI has woken up.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return uint32_t - Number of wakeups since startup.
+ */
+uint32_t CliGetWakeupCount(void)
+{
+    return cliInstance.wakeups;
+}
+
+/**
+ * @brief Returns the number of input lines discarded because of an RX overrun.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return uint32_t - Number of lines discarded since startup.
+ */
+uint32_t CliGetDroppedLineCount(void)
+{
+    return cliInstance.rxDroppedLines;
+}
+
+#ifdef CLI_GET_TIME_US
+/**
+ * @brief Copies the histogram of the bus turnaround time.
+ *
+ * \param[in]  none;
+ * \param[out] buckets - Array of CLI_TURNAROUND_BUCKETS counters;
+ * \return none.
+ */
+void CliGetTurnaroundHistogram(uint32_t *buckets)
+{
+    for (uint8_t ind = 0; ind < CLI_TURNAROUND_BUCKETS; ind++)
+    {
+        buckets[ind] = cliInstance.turnaround[ind];
+    }
+}
+#endif
+
+#if (CLI_BUS_ADDRESSING == 1)
+/**
+ * @brief Sets the address of this unit on the bus.
+ *
+ * \param[in]  address - Address of this unit, 1 to 255;
+ * \param[out] none;
+ * \return none.
+ */
+void CliSetBusAddress(uint8_t address)
+{
+    if (address != 0)
+    {
+        cliInstance.busAddress = address;
+    }
+}
+#endif
+
+//=====================================================================[ PRIVATE FUNCTIONS ]============================================================================================== //
+
+/**
+ * @brief CLI task that processes incoming commands.
+ *
+ * This task blocks on the RX queue without a timeout, buffers the received
+ * characters and processes completed lines: the password while the session is
+ * not authenticated, commands afterwards. It never wakes up on its own, so an
+ * idle console does not keep the system out of tickless idle.
+ *
+ * \param[in]  argument - Unused task parameter;
+ * \param[out] none;
+ * \return none.
+ */
+static void cliTask(void *argument)
+{
+    /* Setting the initial authentication state */
+    cliInstance.authState = FSM_LOG_IN;
+
+    /* Keep the continuation and scratch memory of commands in this session */
+    FreeRTOS_CLIInitContext(&cliInstance.cmdContext, cliInstance.arena, sizeof(cliInstance.arena));
+    FreeRTOS_CLISetContext(&cliInstance.cmdContext);
+
+#if (CLI_SCRIPT_BOOT_SLOT >= 0)
+    /* Provision the device from the boot script before the first prompt; its output is
+       not transmitted, as no session is logged in and units on a bus must stay silent */
+    if (CliScriptLength(CLI_SCRIPT_BOOT_SLOT) > 0)
+    {
+        snprintf(cliInstance.rxBuffer, CLI_RX_BUFFER_SIZE, "exec %d", CLI_SCRIPT_BOOT_SLOT);
+        cliDispatchCommand(cliInstance.rxBuffer);
+    }
+#endif
+
+    /* Prompt for the password */
+    cliAuthenticate();
+
+    /* Infinite loop for CLI processing */
+    while (1)
+    {
+        /* Wait for a character from the RX queue (blocks until data is received) */
+        if (xQueueReceive(cliInstance.rxQueue, &cliInstance.rxChar, portMAX_DELAY) == pdPASS)
+        {
+            cliInstance.wakeups++;
+
+#if (CLI_FLOW_CONTROL != CLI_FLOW_NONE)
+            /* Let the host resume once the queue has drained */
+            taskENTER_CRITICAL();
+            if (cliInstance.rxThrottled &&
+                (uxQueueMessagesWaiting(cliInstance.rxQueue) <= CLI_RX_LOW_WATERMARK))
+            {
+                cliRxThrottle(false);
+            }
+            taskEXIT_CRITICAL();
+#endif
+
+            /* The session timer expired while the task was blocked, and no activity restarted it since */
+            if (cliInstance.logoutPending)
+            {
+                cliInstance.logoutPending = false;
+
+                if (xTimerIsTimerActive(cliInstance.sessionTimer) == pdFALSE)
+                {
+                    cliLogout();
+                    continue;
+                }
+            }
+
+#if (CLI_JOB_COUNT > 0)
+            /* Run the due jobs on the timer's wakeup or between two command lines, never halfway
+               through a line being typed; each at most once per wakeup so that a job slower
+               than its period cannot lock the console out */
+            if ((cliInstance.rxChar == CLI_NULL_CHAR) || (cliInstance.rxIndex == 0))
+            {
+                for (uint8_t ind = 0; ind < CLI_JOB_COUNT; ind++)
+                {
+                    int16_t job = CliJobTake();
+
+                    if (job < 0)
+                    {
+                        break;
+                    }
+
+                    cliDispatchJob(job);
+                }
+            }
+#endif
+
+            switch (cliInstance.rxChar)
+            {
+            case CLI_NULL_CHAR:
+                /* Wakeup sent by the session or job timer, or a stray character */
+                break;
+
+            case CLI_CAN_CHAR:
+                /* The end of the line was lost to an overrun, discard its beginning */
+                memset(cliInstance.rxBuffer, 0, sizeof(cliInstance.rxBuffer));
+                cliInstance.rxIndex = 0;
+                cliSendMessage(INPUT_OVERRUN);
+#if (CLI_BUS_ADDRESSING == 1)
+                cliInstance.slotPending = false;
+#endif
+                break;
+
+#if (CLI_BUS_ADDRESSING == 1)
+            case CLI_STX_CHAR:
+                /* The line is a broadcast, reply in this unit's slot */
+                cliInstance.slotPending = true;
+                break;
+#endif
+
+            case CLI_END_CHAR:
+                cliInstance.rxBuffer[cliInstance.rxIndex] = CLI_NULL_CHAR;
+
+                if (cliInstance.authState == FSM_LOG_OUT)
+                {
+                    /* Execute the command in a worker sized for it */
+                    cliDispatchCommand(cliParseRequestId(cliInstance.rxBuffer));
+                    cliInstance.requestTagged = false;
+                }
+                else
+                {
+                    /* The line is the password */
+                    cliInstance.authState = FSM_PROCESS;
+                    cliAuthenticate();
+                }
+
+#if (CLI_BUS_ADDRESSING == 1)
+                cliInstance.slotPending = false;
+#endif
+                cliInstance.rxIndex = 0; // Reset index for the next command
+                break;
+
+            case CLI_BS_CHAR:
+                if (cliInstance.rxIndex > 0)
+                {
+                    cliInstance.rxIndex--;
+                    cliInstance.rxBuffer[cliInstance.rxIndex] = CLI_NULL_CHAR;
+                }
+                break;
+
+            default:
+                if (cliInstance.rxIndex < CLI_RX_BUFFER_SIZE - 1)
+                {
+                    cliInstance.rxBuffer[cliInstance.rxIndex++] = cliInstance.rxChar;
+                }
+                break;
+            }
+
+#if (CLI_SESSION_TIMEOUT_MS > 0)
+            /* Any input, and the end of a command, restarts the inactivity period; a wakeup is not input */
+            if ((cliInstance.authState == FSM_LOG_OUT) &&
+                (cliInstance.rxChar != CLI_NULL_CHAR))
+            {
+                xTimerReset(cliInstance.sessionTimer, 0);
+
+                /* An expiry during a long command is superseded by its completion */
+                cliInstance.logoutPending = false;
+            }
+#endif
+        }
+    }
+}
+
+/**
+ * @brief Command worker task that executes command lines handed over by the CLI task.
+ *
+ * The worker sleeps until the CLI task notifies it, executes the command line,
+ * records how much of its stack has been used so far against the command and
+ * notifies the CLI task back. Since the high-water mark only grows, the value
+ * recorded is an upper bound of the command's own stack usage.
+ *
+ * \param[in]  argument - Pointer to the worker's Cli_Worker_s;
+ * \param[out] none;
+ * \return none.
+ */
+static void cliWorkerTask(void *argument)
+{
+    Cli_Worker_s *worker = (Cli_Worker_s *)argument;
+
+    while (1)
+    {
+        /* Wait for a command line from the CLI task */
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        cliInstance.wakeups++;
+
+#if (CLI_JOB_COUNT > 0)
+        if (worker->job >= 0)
+        {
+            cliExecuteJob(worker->job);
+        }
+        else
+#endif
+        {
+            cliExecuteCommand(worker->command);
+        }
+
+#if (configCOMMAND_INT_USE_STATS == 1) && (INCLUDE_uxTaskGetStackHighWaterMark == 1)
+        if (worker->item != NULL)
+        {
+            uint16_t stackUsed = worker->stackDepth - (uint16_t)uxTaskGetStackHighWaterMark(NULL);
+
+            if (stackUsed > worker->item->xStats.usStackUsed)
+            {
+                worker->item->xStats.usStackUsed = stackUsed;
+            }
+        }
+#endif
+
+        /* Report completion to the CLI task */
+        xTaskNotifyGive(cliInstance.taskHandle);
+    }
+}
+
+/**
+ * @brief Creates the smallest worker, the larger ones replace it while they are needed.
+ *
+ * The smallest worker is created at startup, as it runs unknown commands and commands
+ * that declare no stack requirement. Only one worker exists at a time: a command that
+ * needs a larger stack class gets its worker in place of the smallest one, which is
+ * created again once the command has completed.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return     int16_t - 0 on success, negative value if the worker could not be created.
+ */
+static int16_t cliCreateWorkers(void)
+{
+    for (uint8_t ind = 0; ind < CLI_WORKER_COUNT; ind++)
+    {
+        cliInstance.workers[ind].stackDepth = cliWorkerStackSizes[ind];
+        cliInstance.workers[ind].taskHandle = NULL;
+    }
+
+    return (cliCreateWorker(0) == pdPASS) ? 0 : -1;
+}
+
+/**
+ * @brief Creates the task of a worker.
+ *
+ * \param[in]  worker - Index of the worker;
+ * \param[out] none;
+ * \return     BaseType_t - pdPASS on success, otherwise pdFAIL.
+ */
+static BaseType_t cliCreateWorker(uint8_t worker)
+{
+    BaseType_t taskStatus = xTaskCreate(cliWorkerTask,
+                                        "CLI_Worker",
+                                        cliInstance.workers[worker].stackDepth,
+                                        &cliInstance.workers[worker],
+                                        CLI_TASK_PRIORITY,
+                                        &cliInstance.workers[worker].taskHandle);
+    if (taskStatus != pdPASS)
+    {
+        cliInstance.workers[worker].taskHandle = NULL;
+    }
+
+    return taskStatus;
+}
+
+/**
+ * @brief Selects the smallest worker whose stack fits the requested depth, creating it in place of the existing one if needed.
+ *
+ * The idle worker is deleted before the selected one is created, so the task
+ * stacks never exceed that of the CLI task plus the largest worker class. If
+ * no worker is large enough the largest one is selected, and if the heap has
+ * no room for the selected one a smaller one is; its usage then shows up in
+ * the stats table.
+ *
+ * \param[in]  stackDepth - Stack depth required, in words;
+ * \param[out] none;
+ * \return     Cli_Worker_s* - Selected worker, NULL if the heap has no room for any worker.
+ */
+static Cli_Worker_s *cliSelectWorker(uint16_t stackDepth)
+{
+    uint8_t selected = 0;
+
+    while ((selected < (CLI_WORKER_COUNT - 1)) && (cliWorkerStackSizes[selected] < stackDepth))
+    {
+        selected++;
+    }
+
+    if (cliInstance.workers[selected].taskHandle == NULL)
+    {
+        /* The workers are idle between two commands, the existing one makes room */
+        for (uint8_t ind = 0; ind < CLI_WORKER_COUNT; ind++)
+        {
+            if (cliInstance.workers[ind].taskHandle != NULL)
+            {
+                vTaskDelete(cliInstance.workers[ind].taskHandle);
+                cliInstance.workers[ind].taskHandle = NULL;
+            }
+        }
+
+        while ((cliCreateWorker(selected) != pdPASS) && (selected > 0))
+        {
+            selected--;
+        }
+    }
+
+    return (cliInstance.workers[selected].taskHandle != NULL) ? &cliInstance.workers[selected] : NULL;
+}
+
+/**
+ * @brief Hands a completed command line to a worker and waits until it has been executed.
+ *
+ * \param[in]  command - Command line to execute;
+ * \param[out] none;
+ * \return     none.
+ */
+static void cliDispatchCommand(const char *command)
+{
+    CLI_Definition_List_Item_t *item = FreeRTOS_CLIFindCommand(command);
+    uint16_t stackDepth = (item != NULL) ? item->pxCommandLineDefinition->usStackDepth : 0;
+    Cli_Worker_s *worker = cliSelectWorker(stackDepth);
+
+    if (worker == NULL)
+    {
+        if (cliInstance.authState == FSM_LOG_OUT)
+        {
+            cliSendMessage(OUT_OF_MEMORY);
+        }
+        return;
+    }
+
+    worker->command = command;
+    worker->item = item;
+    worker->job = -1;
+
+    xTaskNotifyGive(worker->taskHandle);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    /* Give the stack of a larger worker back to the smallest one */
+    (void)cliSelectWorker(0);
+}
+
+/**
+ * @brief Executes a command line and transmits its output chunk by chunk.
+ *
+ * The output is only transmitted while a session is logged in, so the boot
+ * script runs silently.
+ *
+ * \param[in]  command - Command line to execute;
+ * \param[out] none;
+ * \return     none.
+ */
+static void cliExecuteCommand(const char *command)
+{
+    BaseType_t returnStatus = pdFALSE;
+    size_t length = 0;
+
+    do
+    {
+        /* Process the command using FreeRTOS + CLI */
+        cliInstance.txBuffer[0] = CLI_NULL_CHAR;
+        returnStatus = FreeRTOS_CLIProcessCommand(command,
+                                                  cliInstance.txBuffer,
+                                                  CLI_TX_BUFFER_SIZE);
+
+        char queueBuff = CLI_TX_COMPLETE;
+        length = FreeRTOS_CLIGetOutputLength(cliInstance.txBuffer);
+
+        /* An empty chunk produces no TX complete event, there is nothing to wait for */
+        if ((length > 0) && (cliInstance.authState == FSM_LOG_OUT))
+        {
+            /* Send next chunk, keep the driver enabled if more chunks follow */
+            cliWrite((uint8_t *)&cliInstance.txBuffer, (uint16_t)length, (returnStatus != pdFALSE));
+
+            /* Wait for the TX complete or error callback, without a timeout */
+            xQueueReceive(cliInstance.txQueue, &queueBuff, portMAX_DELAY);
+            cliInstance.wakeups++;
+        }
+
+        if (returnStatus == pdFALSE)
+        {
+            break;
+        }
+
+        if (queueBuff == CLI_MSG_ERR)
+        {
+            /* The rest of the output cannot be delivered, cancel the command */
+            FreeRTOS_CLIAbortCommand();
+            break;
+        }
+    } while (1);
+
+    if (cliInstance.requestTagged)
+    {
+        /* Tells a pipelining client that the output of this request is complete */
+        cliSendRequestEnd();
+    }
+
+    /* The last chunk may have been empty while the bus was held */
+    cliReleaseBus();
+}
+
+#if (CLI_JOB_COUNT > 0)
+/**
+ * @brief Hands a due job to a worker and waits until it has been executed.
+ *
+ * \param[in]  job - Number of the job taken with CliJobTake();
+ * \param[out] none;
+ * \return     none.
+ */
+static void cliDispatchJob(int16_t job)
+{
+    CLI_Definition_List_Item_t *item = CliJobCommand(job);
+    uint16_t stackDepth = (item != NULL) ? item->pxCommandLineDefinition->usStackDepth : 0;
+    Cli_Worker_s *worker = cliSelectWorker(stackDepth);
+
+    /* A job that finds no room for a worker is skipped until its next run */
+    if (worker == NULL)
+    {
+        return;
+    }
+
+    worker->command = NULL;
+    worker->item = item;
+    worker->job = job;
+
+    xTaskNotifyGive(worker->taskHandle);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    /* Give the stack of a larger worker back to the smallest one */
+    (void)cliSelectWorker(0);
+}
+
+/**
+ * @brief Executes a job and transmits the output of a console job chunk by chunk.
+ *
+ * The output is only transmitted while a session is logged in, and never by a
+ * unit on a multi-drop bus, which must only talk when it is asked to.
+ *
+ * \param[in]  job - Number of the job;
+ * \param[out] none;
+ * \return     none.
+ */
+static void cliExecuteJob(int16_t job)
+{
+    BaseType_t returnStatus = pdFALSE;
+    size_t length = 0;
+
+    do
+    {
+        cliInstance.txBuffer[0] = CLI_NULL_CHAR;
+        returnStatus = CliJobProcess(job, cliInstance.txBuffer, CLI_TX_BUFFER_SIZE);
+
+        char queueBuff = CLI_TX_COMPLETE;
+        length = FreeRTOS_CLIGetOutputLength(cliInstance.txBuffer);
+
+        /* The output of a job logged in RAM has already been moved to the log */
+        if ((length > 0) &&
+            (cliInstance.authState == FSM_LOG_OUT) &&
+            (CLI_BUS_ADDRESSING == 0))
+        {
+            cliWrite((uint8_t *)&cliInstance.txBuffer, (uint16_t)length, (returnStatus != pdFALSE));
+
+            /* Wait for the TX complete or error callback, without a timeout */
+            xQueueReceive(cliInstance.txQueue, &queueBuff, portMAX_DELAY);
+            cliInstance.wakeups++;
+        }
+    } while (returnStatus != pdFALSE);
+
+    /* The last chunk may have been empty while the bus was held */
+    cliReleaseBus();
+}
+
+/**
+ * @brief Job timer callback, wakes the CLI task to run the due jobs.
+ *
+ * Runs in the timer service task. A null character is queued to wake the CLI
+ * task; if the RX queue is full the failure is reported, so that the job
+ * timer is re-armed instead of the due jobs waiting for the next line.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return     BaseType_t - pdPASS if the wakeup was queued, pdFAIL if the RX queue is full.
+ */
+static BaseType_t cliJobWakeupCb(void)
+{
+    char wakeChar = CLI_NULL_CHAR;
+
+    return (xQueueSendToFront(cliInstance.rxQueue, &wakeChar, 0) == pdPASS) ? pdPASS : pdFAIL;
+}
+#endif
+
+/**
+ * @brief Strips the request ID prefix of a command line.
+ *
+ * A client that keeps several commands in flight prefixes each line with
+ * "%<id> ", a decimal number of its choice. The command is executed as if
+ * the prefix was not there, and its output is followed by an end marker
+ * carrying the same ID and the exit status, so the client knows which
+ * request the output belongs to and when it is complete. Lines without a
+ * valid prefix, including an ID larger than 32 bits, are executed unchanged
+ * and get no end marker.
+ *
+ * \param[in]  line - Command line, possibly starting with "%<id> ";
+ * \param[out] none;
+ * \return     const char* - The command line without the prefix.
+ */
+static const char *cliParseRequestId(const char *line)
+{
+    const char *cursor = &line[1];
+    uint32_t id = 0;
+
+    if ((line[0] != CLI_REQUEST_ID_CHAR) ||
+        (*cursor < '0') || (*cursor > '9'))
+    {
+        return line;
+    }
+
+    while ((*cursor >= '0') && (*cursor <= '9'))
+    {
+        uint32_t digit = (uint32_t)(*cursor - '0');
+
+        /* An ID that wrapped would be echoed as another one */
+        if (id > ((UINT32_MAX - digit) / 10U))
+        {
+            return line;
+        }
+
+        id = (id * 10U) + digit;
+        cursor++;
+    }
+
+    if (*cursor != ' ')
+    {
+        return line;
+    }
+
+    while (*cursor == ' ')
+    {
+        cursor++;
+    }
+
+    cliInstance.requestId = id;
+    cliInstance.requestTagged = true;
+
+    return cursor;
+}
+
+/**
+ * @brief Transmits the end marker of a command that was prefixed with a request ID.
+ *
+ * As text the marker is the line "%<id> <status>". In the structured formats it
+ * is an {id, status} record, so a client decoding a stream of records needs
+ * no special case. The status is a cliSTATUS_xxx value.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return     none.
+ */
+static void cliSendRequestEnd(void)
+{
+    BaseType_t status = FreeRTOS_CLIGetStatus();
+    char queueBuff = CLI_TX_COMPLETE;
+    CLI_Record_t record;
+    size_t length = 0;
+
+    if (FreeRTOS_CLIGetFormat() == cliFORMAT_TEXT)
+    {
+        int written = snprintf(cliInstance.txBuffer, CLI_TX_BUFFER_SIZE, "%c%lu %d\r\n",
+                               CLI_REQUEST_ID_CHAR, (unsigned long)cliInstance.requestId, (int)status);
+        length = (written > 0) ? (size_t)written : 0;
+    }
+    else
+    {
+        FreeRTOS_CLIRecordInit(&record, cliInstance.txBuffer, CLI_TX_BUFFER_SIZE);
+        FreeRTOS_CLIRecordBegin(&record);
+        FreeRTOS_CLIRecordUnsigned(&record, "id", cliInstance.requestId);
+        FreeRTOS_CLIRecordSigned(&record, "status", (int32_t)status);
+        (void)FreeRTOS_CLIRecordEnd(&record);
+        length = FreeRTOS_CLIRecordLength(&record);
+    }
+
+    if (length > 0)
+    {
+        cliWrite((uint8_t *)&cliInstance.txBuffer, (uint16_t)length, false);
+        xQueueReceive(cliInstance.txQueue, &queueBuff, portMAX_DELAY);
+        cliInstance.wakeups++;
+    }
+}
+
+/**
+ * @brief Starts the transmission of output of the CLI task.
+ *
+ * The driver is enabled here and released by the TX complete callback as soon
+ * as the last stop bit has left, unless holdBus announces more output.
+ *
+ * With XON/XOFF flow control, a flow control character may be on the line when
+ * the output is ready. The output is then handed to the TX complete callback,
+ * which starts it as soon as the character has been sent.
+ *
+ * \param[in]  data    - Data to transmit;
+ * \param[in]  length  - Number of bytes to transmit;
+ * \param[in]  holdBus - If true, more output follows and the driver stays enabled;
+ * \param[out] none;
+ * \return     none.
+ */
+static void cliWrite(const uint8_t *data, uint16_t length, bool holdBus)
+{
+#if (CLI_BUS_ADDRESSING == 1)
+    if (cliInstance.slotPending)
+    {
+        /* First output for a broadcast line, wait for this unit's reply slot */
+        TickType_t slotStart = cliInstance.broadcastTick;
+        TickType_t slotOffset = pdMS_TO_TICKS(CLI_BROADCAST_SLOT_MS) * (TickType_t)(cliInstance.busAddress - 1);
+
+        cliInstance.slotPending = false;
+
+        /* Address 1 owns the first slot, the kernel rejects a zero increment */
+        if (slotOffset > 0U)
+        {
+            vTaskDelayUntil(&slotStart, slotOffset);
+        }
+    }
+#endif
+
+#if (CLI_CAPTURE_ENTRIES > 0)
+    CliCaptureTx(length);
+#endif
+
+    cliInstance.txHoldBus = holdBus;
+
+#if (CLI_FLOW_CONTROL == CLI_FLOW_XONXOFF)
+    taskENTER_CRITICAL();
+
+    cliInstance.txBusy = true;
+
+    if (cliInstance.flowCharInFlight)
+    {
+        cliInstance.txPendingData = data;
+        cliInstance.txPendingLength = length;
+    }
+    else
+    {
+        cliSetUartDirectionMode(UART_TX_MODE);
+        io_write(cliInstance.io, data, length);
+    }
+
+    taskEXIT_CRITICAL();
+#else
+    cliSetUartDirectionMode(UART_TX_MODE);
+    io_write(cliInstance.io, data, length);
+#endif
+}
+
+/**
+ * @brief Releases the bus if the CLI task held it for output that did not come.
+ *
+ * The TX complete callback releases the bus after every transmission that does
+ * not hold it; this only covers a command whose last chunk was empty. A flow
+ * control character still on the line is left to complete; its TX complete
+ * callback releases the bus instead.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return     none.
+ */
+static void cliReleaseBus(void)
+{
+    taskENTER_CRITICAL();
+
+    if (cliInstance.txHoldBus)
+    {
+        cliInstance.txHoldBus = false;
+
+#if (CLI_FLOW_CONTROL == CLI_FLOW_XONXOFF)
+        if (!cliInstance.flowCharInFlight)
+#endif
+        {
+            cliSetUartDirectionMode(UART_RX_MODE);
+        }
+    }
+
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Releases the bus from the TX complete or error callback.
  *
- * \param[in]  message - Pointer to the string to be sent;
+ * Switching direction here, rather than in the task that waits for the
+ * completion, makes the turnaround independent of scheduling: the driver is
+ * released CLI_RS485_GUARD_US after the last stop bit plus the interrupt
+ * latency. The guard time is a busy wait and is meant for a few bit times.
+ *
+ * \param[in]  start - Time of the TX complete interrupt, from CLI_TURNAROUND_START();
  * \param[out] none;
  * \return     none.
  */
-static void cliSendMessage(const char *message);
+static void cliReleaseBusFromISR(uint32_t start)
+{
+#if (CLI_RS485_GUARD_US > 0)
+    delay_us(CLI_RS485_GUARD_US);
+#endif
 
-//=======================================================================[PUBLIC INTERFACE FUNCTIONS]===================================================================================== //
+    cliSetUartDirectionMode(UART_RX_MODE);
+
+#ifdef CLI_GET_TIME_US
+    uint32_t bucket = (CLI_GET_TIME_US() - start) / CLI_TURNAROUND_BUCKET_US;
+
+    if (bucket >= CLI_TURNAROUND_BUCKETS)
+    {
+        bucket = CLI_TURNAROUND_BUCKETS - 1;
+    }
+    cliInstance.turnaround[bucket]++;
+#else
+    (void)start;
+#endif
+}
 
+#if (CLI_BUS_ADDRESSING == 1)
 /**
- * @brief Initializes the Command Line Interface (CLI).
+ * @brief Address filter of the RX callback.
  *
- * \param[in]  none;
- * \param[out] none;
- * \return int16_t - Returns 0 on successful initialization, or a negative error code on failure.
+ * Runs on every received character and costs a few comparisons. The address
+ * prefix is consumed here; lines for other units, and lines without a valid
+ * prefix, are dropped up to and including their end character. A line feed
+ * or blanks before the prefix are dropped without ending the line start, so
+ * hosts that send CRLF do not lose every second line. The space
+ * that ends the prefix of a broadcast line is replaced by CLI_STX_CHAR so
+ * that the CLI task knows to reply in this unit's slot, and the time the
+ * broadcast line ends is recorded as the origin of the slots.
+ *
+ * \param[in,out] rxChar - Received character, replaced by CLI_STX_CHAR at the start of a broadcast line;
+ * \return        bool - True if the character has to be queued, false if it is dropped.
  */
-int16_t CliStartup(void)
+static bool cliRxFilter(char *rxChar)
 {
-    int16_t status           = 0;           // A variable for storing the execution status
-    int32_t ioResult         = 0;           // A variable for storing the result
-    int32_t rxCbStatus       = ERR_NONE;    // A variable for storing the RX callback function
-    int32_t txCbStatus       = ERR_NONE;    // A variable for storing the TX callback function
-    int32_t errCbStatus      = ERR_NONE;    // A variable for storing the Error callback function
-    int32_t uartEnableStatus = ERR_NONE;    // A variable for storing the UART enable status
+    bool accept = false;
 
-    do
+    switch (cliInstance.rxAddressState)
     {
-        /* Reset UART pins to RX mode before thread creation */
-        cliSetUartDirectionMode(UART_RX_MODE);
-
-        /* Assign the UART instance to the CLI structure */
-        cliInstance.uart = &SERVICE_UART;
-
-        /* Get the I/O descriptor and store it */
-        ioResult = usart_async_get_io_descriptor(cliInstance.uart, &cliInstance.io);
-        if ((ioResult != ERR_NONE) ||
-            (cliInstance.io == NULL))
+    case CLI_RX_LINE_START:
+        if (*rxChar == CLI_ADDRESS_CHAR)
         {
-            break;
+            cliInstance.rxAddress = 0;
+            cliInstance.rxBroadcast = false;
+            cliInstance.rxAddressState = CLI_RX_ADDRESS;
         }
-
-        /* Assign the index for tracking position in the receive buffer */
-        cliInstance.rxIndex = 0;
-
-        /* Clear RX and TX buffers */
-        memset(cliInstance.rxBuffer, 0, CLI_RX_BUFFER_SIZE);
-        memset(cliInstance.txBuffer, 0, CLI_TX_BUFFER_SIZE);
-
-        /* Create queues for RX and TX communication */
-        cliInstance.rxQueue = xQueueCreate(CLI_QUEUE_LENGTH, sizeof(char));
-        cliInstance.txQueue = xQueueCreate(CLI_QUEUE_LENGTH, sizeof(char));
-
-        /* Check if queue creation was successful */
-        if ((!cliInstance.rxQueue) ||
-            (!cliInstance.txQueue))
+        else if ((*rxChar != CLI_END_CHAR) && (*rxChar != '\n') &&
+                 (*rxChar != ' ') && (*rxChar != '\t'))
         {
-            status = -1;
-            break;
+            /* The LF of a CRLF host and leading blanks are noise, not a line */
+            cliInstance.rxAddressState = CLI_RX_DISCARD;
         }
+        break;
 
-        /* Initialize CLI commands by registering them with FreeRTOS CLI */
-        CliCmdInit();
-
-        /* Register the UART RX, TX, Err callback functions */
-        rxCbStatus = usart_async_register_callback(cliInstance.uart, USART_ASYNC_RXC_CB, cliRxReceivedCb);
-        txCbStatus = usart_async_register_callback(cliInstance.uart, USART_ASYNC_TXC_CB, cliTxCompletedCb);
-        errCbStatus = usart_async_register_callback(cliInstance.uart, USART_ASYNC_ERROR_CB, cliRxTxErr);
-
-        /* Check the success of registration of all callbacks */
-        if ((rxCbStatus != ERR_NONE) ||
-            (txCbStatus != ERR_NONE) ||
-            (errCbStatus != ERR_NONE))
+    case CLI_RX_ADDRESS:
+        if ((*rxChar >= '0') && (*rxChar <= '9') && (cliInstance.rxAddress <= UINT8_MAX))
         {
-            status = -2;
-            break;
+            cliInstance.rxAddress = (uint16_t)(cliInstance.rxAddress * 10 + (*rxChar - '0'));
         }
-
-        /* Enable UART communication */
-        uartEnableStatus = usart_async_enable(cliInstance.uart);
-        if (uartEnableStatus != ERR_NONE)
+        else if ((*rxChar == CLI_BROADCAST_CHAR) && (cliInstance.rxAddress == 0))
         {
-            status = -3;
-            break;
+            cliInstance.rxBroadcast = true;
         }
+        else if ((*rxChar == ' ') &&
+                 (cliInstance.rxBroadcast || (cliInstance.rxAddress == cliInstance.busAddress)))
+        {
+            cliInstance.rxAddressState = CLI_RX_ACCEPT;
 
-        /* Set UART to receive mode (RX) */
-        cliSetUartDirectionMode(UART_RX_MODE);
-
-        /* Create the CLI processing task */
-        BaseType_t taskStatus = xTaskCreate(cliTask,
-                                            "CLI_Task",
-                                            512,
-                                            NULL,
-                                            3,
-                                            &cliInstance.taskHandle);
+            if (cliInstance.rxBroadcast)
+            {
+                *rxChar = CLI_STX_CHAR;
+                accept = true;
+            }
+        }
+        else
+        {
+            cliInstance.rxAddressState = (*rxChar == CLI_END_CHAR) ? CLI_RX_LINE_START : CLI_RX_DISCARD;
+        }
+        break;
 
-        /* Check taskStatus */
-        if (taskStatus != pdPASS)
+    case CLI_RX_ACCEPT:
+        if (*rxChar == CLI_END_CHAR)
         {
-            status = -4;
-            break;
+            if (cliInstance.rxBroadcast)
+            {
+                cliInstance.broadcastTick = xTaskGetTickCountFromISR();
+            }
+            cliInstance.rxAddressState = CLI_RX_LINE_START;
         }
+        accept = true;
+        break;
 
-    } while (0);
+    case CLI_RX_DISCARD:
+    default:
+        if (*rxChar == CLI_END_CHAR)
+        {
+            cliInstance.rxAddressState = CLI_RX_LINE_START;
+        }
+        break;
+    }
 
-    return status;
+    return accept;
 }
+#endif
 
-//=====================================================================[ PRIVATE FUNCTIONS ]============================================================================================== //
-
+#if (CLI_FLOW_CONTROL != CLI_FLOW_NONE)
 /**
- * @brief CLI task that processes incoming commands.
+ * @brief Asks the host to stop or to resume sending.
  *
- * This task continuously reads characters from the RX queue, buffers them,
- * and processes completed commands. Processed output is sent to the TX queue.
+ * Called from the RX callback when the queue reaches the high watermark, and
+ * from the CLI task, inside a critical section, once it has drained to the
+ * low watermark.
  *
- * \param[in]  argument - Unused task parameter;
+ * \param[in]  throttle - If true, the host is asked to stop; otherwise, to resume;
  * \param[out] none;
- * \return none.
+ * \return     none.
  */
-static void cliTask(void *argument)
+static void cliRxThrottle(bool throttle)
 {
-    BaseType_t returnStatus = pdFALSE;
+    cliInstance.rxThrottled = throttle;
 
-    /* Setting the initial authentication state */
-    cliInstance.authState = FSM_LOG_IN;
+#if (CLI_FLOW_CONTROL == CLI_FLOW_RTS)
+    /* RTS is active low: a high level asks the host to stop */
+    gpio_set_pin_level(CLI_RTS_PIN, throttle);
+#else
+    cliInstance.flowChar = throttle ? CLI_XOFF_CHAR : CLI_XON_CHAR;
 
-    /* Infinite loop for CLI processing */
-    while (1)
+    if (cliInstance.txBusy || cliInstance.flowCharInFlight)
     {
+        /* Sent by the TX complete callback, the latest request wins */
+        cliInstance.flowCharPending = true;
+    }
+    else
+    {
+        cliSendFlowChar();
+    }
+#endif
+}
+#endif
 
-        cliAuthenticate();
-
-        /* Wait for a character from the RX queue (blocks until data is received) */
-        if (xQueueReceive(cliInstance.rxQueue, &cliInstance.rxChar, portMAX_DELAY) == pdPASS)
-        {
-
-            switch (cliInstance.rxChar)
-            {
-            case CLI_END_CHAR:
-                cliInstance.rxBuffer[cliInstance.rxIndex] = CLI_NULL_CHAR;
-                do
-                {
-                    /* Process the command using FreeRTOS + CLI */
-                    returnStatus = FreeRTOS_CLIProcessCommand(cliInstance.rxBuffer,
-                                                              cliInstance.txBuffer,
-                                                              CLI_TX_BUFFER_SIZE);
-
-                    /* Set UART to transmit mode (TX) */
-                    cliSetUartDirectionMode(UART_TX_MODE);
-
-                    /* Send next symbol */
-                    int32_t writeStatus = io_write(cliInstance.io,
-                                                   (uint8_t *)&cliInstance.txBuffer,
-                                                   strlen(cliInstance.txBuffer));
-
-                    char queueBuff = 0;
-                    xQueueReceive(cliInstance.txQueue, &queueBuff, 1000);
-
-                    if ((returnStatus == pdFALSE) ||
-                        (queueBuff == 2))
-                    {
-                        break;
-                    }
-                } while (1);
-
-                /* Set UART to receive mode (RX). */
-                cliSetUartDirectionMode(UART_RX_MODE);
-
-                cliInstance.rxIndex = 0; // Reset index for the next command
-                break;
-
-            case CLI_BS_CHAR:
-                if (cliInstance.rxIndex > 0)
-                {
-                    cliInstance.rxIndex--;
-                    cliInstance.rxBuffer[cliInstance.rxIndex] = CLI_NULL_CHAR;
-                }
-                break;
+#if (CLI_FLOW_CONTROL == CLI_FLOW_XONXOFF)
+/**
+ * @brief Transmits the last flow control character requested.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return     none.
+ */
+static void cliSendFlowChar(void)
+{
+    cliInstance.flowCharPending = false;
+    cliInstance.flowCharInFlight = true;
 
-            default:
-                if (cliInstance.rxIndex < CLI_RX_BUFFER_SIZE - 1)
-                {
-                    cliInstance.rxBuffer[cliInstance.rxIndex++] = cliInstance.rxChar;
-                }
-                break;
-            }
-        }
-    }
+    cliSetUartDirectionMode(UART_TX_MODE);
+    io_write(cliInstance.io, (uint8_t *)&cliInstance.flowChar, 1);
 }
+#endif
 
 /**
  * @brief Configures UART to receive or transmit mode.
@@ -313,12 +1366,20 @@ static void cliSetUartDirectionMode(Cli_UartMode_e UartMode)
  * This function is called when a character is received via UART.
  * The received character is placed into the RX queue for processing.
  *
+ * If the queue is full, the character is dropped along with the rest of its
+ * line, and the end of the line is replaced by CLI_CAN_CHAR so that the CLI
+ * task discards the beginning too: a command is never executed with characters
+ * missing. When flow control is enabled, the host is asked to stop once the
+ * queue reaches CLI_RX_HIGH_WATERMARK, which normally prevents the overrun.
+ *
  * \param[in]  uart - Pointer to the USART descriptor;
  * \param[out] none;
  * \return     none.
  */
 static void cliRxReceivedCb(const struct usart_async_descriptor *const uart)
 {
+    /* Never cliInstance.rxChar: the CLI task may be reading it when the interrupt fires */
+    char rxChar = CLI_NULL_CHAR;
 
     do
     {
@@ -328,8 +1389,8 @@ static void cliRxReceivedCb(const struct usart_async_descriptor *const uart)
             break;
         }
 
-        /* Read one character from UART into receivedChar */
-        int32_t readStatus = io_read(cliInstance.io, (uint8_t *)&cliInstance.rxChar, 1);
+        /* Read one character from UART */
+        int32_t readStatus = io_read(cliInstance.io, (uint8_t *)&rxChar, 1);
         if (readStatus <= 0)
         {
             break;
@@ -338,18 +1399,57 @@ static void cliRxReceivedCb(const struct usart_async_descriptor *const uart)
         /* Flag to indicate if a higher-priority task has been unblocked during the ISR */
         BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 
+#if (CLI_CAPTURE_ENTRIES > 0)
+        /* Log the character as it arrived, before any filtering */
+        CliCaptureRx(rxChar);
+#endif
+
+#if (CLI_BUS_ADDRESSING == 1)
+        /* Drop the lines addressed to other units */
+        if (!cliRxFilter(&rxChar))
+        {
+            break;
+        }
+#endif
+
+        if (cliInstance.rxDiscarding)
+        {
+            /* Drop the rest of the overrun line, then have the task discard its beginning */
+            if (rxChar != CLI_END_CHAR)
+            {
+                break;
+            }
+            rxChar = CLI_CAN_CHAR;
+        }
+
         /* Try to send the character to the RX queue */
         BaseType_t queueSendStatus = xQueueSendFromISR(cliInstance.rxQueue,
-                                                       &cliInstance.rxChar,
+                                                       &rxChar,
                                                        &xHigherPriorityTaskWoken);
 
         /* Check queue creation status*/
         if (queueSendStatus != pdPASS)
         {
-            /* Handle other errors */
+            /* Overrun, shed the whole line rather than a few characters of it */
+            if (!cliInstance.rxDiscarding)
+            {
+                cliInstance.rxDiscarding = true;
+                cliInstance.rxDroppedLines++;
+            }
             break;
         }
 
+        cliInstance.rxDiscarding = false;
+
+#if (CLI_FLOW_CONTROL != CLI_FLOW_NONE)
+        /* Ask the host to stop before the queue overflows */
+        if (!cliInstance.rxThrottled &&
+            (uxQueueMessagesWaitingFromISR(cliInstance.rxQueue) >= CLI_RX_HIGH_WATERMARK))
+        {
+            cliRxThrottle(true);
+        }
+#endif
+
         /* If a higher priority task was woken, request a context switch */
         portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 
@@ -360,7 +1460,10 @@ static void cliRxReceivedCb(const struct usart_async_descriptor *const uart)
  * @brief UART TX callback function.
  *
  * This function is called when the UART transmission is completed.
- * It retrieves the next character from the TX queue and sends it via UART.
+ * It reports the completion of the output to the CLI task through the TX queue.
+ * With XON/XOFF flow control, the completion of a flow control character is
+ * not reported; the output deferred behind it, or a flow control character
+ * requested during the output, is started instead.
  *
  * \param[in]  uart - Pointer to the USART descriptor;
  * \param[out] none;
@@ -368,6 +1471,8 @@ static void cliRxReceivedCb(const struct usart_async_descriptor *const uart)
  */
 static void cliTxCompletedCb(const struct usart_async_descriptor *const uart)
 {
+    uint32_t start = CLI_TURNAROUND_START();
+
     do
     {
         /* Check that the UART I/O descriptor is available */
@@ -377,6 +1482,30 @@ static void cliTxCompletedCb(const struct usart_async_descriptor *const uart)
             break;
         }
 
+#if (CLI_FLOW_CONTROL == CLI_FLOW_XONXOFF)
+        if (cliInstance.flowCharInFlight)
+        {
+            cliInstance.flowCharInFlight = false;
+
+            if (cliInstance.txPendingLength > 0)
+            {
+                io_write(cliInstance.io, cliInstance.txPendingData, cliInstance.txPendingLength);
+                cliInstance.txPendingLength = 0;
+            }
+            else if (cliInstance.flowCharPending)
+            {
+                cliSendFlowChar();
+            }
+            else if (!cliInstance.txHoldBus)
+            {
+                cliReleaseBusFromISR(start);
+            }
+            break;
+        }
+
+        cliInstance.txBusy = false;
+#endif
+
         /* Message indicating that transmission was completed successfully */
         CliTxStatus_e msg = CLI_TX_COMPLETE;
 
@@ -391,6 +1520,20 @@ static void cliTxCompletedCb(const struct usart_async_descriptor *const uart)
             ASSERT(0);
         }
 
+#if (CLI_FLOW_CONTROL == CLI_FLOW_XONXOFF)
+        if (cliInstance.flowCharPending)
+        {
+            cliSendFlowChar();
+            break;
+        }
+#endif
+
+        /* Release the bus now rather than when the CLI task gets to run */
+        if (!cliInstance.txHoldBus)
+        {
+            cliReleaseBusFromISR(start);
+        }
+
     } while (0);
 }
 
@@ -415,6 +1558,17 @@ static void cliRxTxErr(const struct usart_async_descriptor *const uart)
             break;
         }
 
+#if (CLI_FLOW_CONTROL == CLI_FLOW_XONXOFF)
+        /* The output is abandoned, nothing deferred behind it is sent */
+        cliInstance.txBusy = false;
+        cliInstance.flowCharInFlight = false;
+        cliInstance.txPendingLength = 0;
+#endif
+
+        /* The rest of the output is abandoned, give the bus back */
+        cliInstance.txHoldBus = false;
+        cliSetUartDirectionMode(UART_RX_MODE);
+
         /* Message indicating that an error occurred during transmission */
         CliTxStatus_e msg = CLI_MSG_ERR;
 
@@ -432,6 +1586,67 @@ static void cliRxTxErr(const struct usart_async_descriptor *const uart)
     } while (0);
 }
 
+/**
+ * @brief Session timer callback, requests the logout of the inactive session.
+ *
+ * Runs in the timer service task. The logout itself is left to the CLI task,
+ * which owns the session; a null character is queued to wake it up. If the RX
+ * queue is full the CLI task is already about to run and sees the flag anyway.
+ *
+ * \param[in]  timer - Handle of the session timer;
+ * \param[out] none;
+ * \return     none.
+ */
+static void cliSessionTimeoutCb(TimerHandle_t timer)
+{
+    char wakeChar = CLI_NULL_CHAR;
+
+    (void)timer;
+
+    cliInstance.logoutPending = true;
+    xQueueSendToFront(cliInstance.rxQueue, &wakeChar, 0);
+}
+
+/**
+ * @brief Logs the session out and releases the resources it holds.
+ *
+ * Discards any partial input, cancels the jobs printing to the console,
+ * releases the command context and clears its arena so nothing of the
+ * session is left for the next user, then prompts for the password again.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return     none.
+ */
+static void cliLogout(void)
+{
+    cliInstance.logoutPending = false;
+
+#if (CLI_SESSION_TIMEOUT_MS > 0)
+    xTimerStop(cliInstance.sessionTimer, 0);
+#endif
+
+#if (CLI_JOB_COUNT > 0)
+    /* Jobs printing to the console belong to the session */
+    CliJobCancelConsole();
+#endif
+
+    /* Release the command context and its scratch memory */
+    FreeRTOS_CLIAbortCommand();
+    memset(cliInstance.arena, 0, sizeof(cliInstance.arena));
+    FreeRTOS_CLIInitContext(&cliInstance.cmdContext, cliInstance.arena, sizeof(cliInstance.arena));
+
+    /* Discard the partial input and the last output */
+    memset(cliInstance.rxBuffer, 0, sizeof(cliInstance.rxBuffer));
+    memset(cliInstance.txBuffer, 0, sizeof(cliInstance.txBuffer));
+    cliInstance.rxIndex = 0;
+
+    cliSendMessage(SESSION_TIMEOUT);
+
+    cliInstance.authState = FSM_LOG_IN;
+    cliAuthenticate();
+}
+
 /**
  * @brief Sends a message over UART and waits for completion.
  *
@@ -445,25 +1660,21 @@ static void cliRxTxErr(const struct usart_async_descriptor *const uart)
  */
 static void cliSendMessage(const char *message)
 {
-    /* Set UART to transmit mode */
-    cliSetUartDirectionMode(UART_TX_MODE);
-
-    /* Send the provided message over UART */
-    io_write(cliInstance.io, (uint8_t *)message, strlen(message));
+    /* Send the provided message over UART, the TX complete callback releases the bus */
+    cliWrite((const uint8_t *)message, (uint16_t)strlen(message), false);
 
     /* Wait until the transmission is fully completed */
     xQueueReceive(cliInstance.txQueue, &cliInstance.txChar, portMAX_DELAY);
-
-    /* Restore UART to receive mode */
-    cliSetUartDirectionMode(UART_RX_MODE);
+    cliInstance.wakeups++;
 }
 
 /**
- * @brief Handles CLI authentication state machine.
+ * @brief Runs the authentication state machine until it has to wait for input.
  *
  * This function manages the authentication process for the CLI using a finite state machine (FSM).
- * It prompts the user for a password and verifies input before granting access.
- * If authentication fails, the user is asked to retry.
+ * It is called by the CLI task when the session starts and each time a password line has been
+ * entered, and returns as soon as the machine reaches a state that waits for an event: FSM_INPUT
+ * (the next line) or FSM_LOG_OUT (access granted). It never polls the input buffer.
  *
  * \param[in]  none;
  * \param[out] none;
@@ -486,32 +1697,32 @@ static void cliAuthenticate(void)
             cliInstance.authState = FSM_INPUT;
             break;
 
-        case FSM_INPUT:
-            /* Check if the user has entered a complete password (ending with newline) */
-            if (strchr(cliInstance.rxBuffer, '\n'))
-            {
-                cliInstance.authState = FSM_PROCESS;
-            }
-            break;
-
-        case
-
+        case FSM_PROCESS:
             /* Remove newline characters from input */
             cliInstance.rxBuffer[strcspn(cliInstance.rxBuffer, "\r\n")] = 0;
 
             /* Validate password */
-            if (strcmp(cliInstance.rxBuffer, PASSWORD) == 0) {
+            if (strcmp(cliInstance.rxBuffer, PASSWORD) == 0)
+            {
                 /* Authentication successful, grant access */
                 memset(cliInstance.rxBuffer, 0, sizeof(cliInstance.rxBuffer));
                 cliInstance.authState = FSM_LOG_OUT;
 
+#if (CLI_SESSION_TIMEOUT_MS > 0)
+                /* Start counting the inactivity of the session */
+                xTimerReset(cliInstance.sessionTimer, 0);
+#endif
+
                 cliSendMessage(AUTH_SUCCESS);
-            } else {
+            }
+            else
+            {
                 /* Authentication failed, go to error state */
                 cliInstance.authState = FSM_ERR;
-            } break;
+            }
+            break;
 
-            case FSM_ERR:
+        case FSM_ERR:
             cliSendMessage(AUTH_FAIL);
 
             /* Reset input buffer and authentication process */
@@ -520,10 +1731,16 @@ static void cliAuthenticate(void)
             cliInstance.authState = FSM_LOG_IN;
             break;
 
+        case FSM_INPUT:
+        case FSM_LOG_OUT:
+            /* Waiting for the next line from the CLI task */
+            break;
+
         default:
             /* Undefined state, reset authentication */
             cliInstance.authState = FSM_ERR;
             break;
         }
-    } while (1);
+    } while ((cliInstance.authState != FSM_INPUT) &&
+             (cliInstance.authState != FSM_LOG_OUT));
 }
\ No newline at end of file
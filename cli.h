@@ -10,6 +10,13 @@
  * The structures and function prototypes defined here manage UART communication,
  * task execution, and buffer handling for CLI input and output processing.
  *
+ * All hardware access goes through the ASF4 USART driver (usart_async_*, io_read,
+ * io_write), the direction pins (gpio_set_pin_level), delay_us() and the time
+ * sources CLI_GET_TIME_US() and CLI_CAPTURE_TIME(). This is the whole surface a
+ * host simulation would have to replace: it would fire the callbacks registered
+ * by CliStartup() at simulated byte times and run the tasks on a FreeRTOS port
+ * driven by a virtual tick. No such simulation is part of this module.
+ *
  * @date Created on 24.03.2025
  * @author Yauheni Bialkou
  */
@@ -23,8 +30,10 @@
 #include "task.h"            // FreeRTOS task management
 #include "queue.h"           // FreeRTOS queue management for UART RX/TX
 #include "semphr.h"          // FreeRTOS semaphore management for synchronization
+#include "timers.h"          // FreeRTOS software timers for the session timeout
 #include "FreeRTOS_CLI.h"    // FreeRTOS CLI API
 #include "hal_usart_async.h" // USART asynchronous communication for UART
+#include "hal_delay.h"       // Busy-wait delays for the RS-485 guard time
 #include "driver_init.h"     // Hardware initialization functions (depends on your project setup)
 #include "atmel_start.h"     // Atmel Start library for peripheral initialization (depends on your project setup)
 #include "cli_cmd.h"
@@ -33,16 +42,50 @@
 
 #define CLI_RX_BUFFER_SIZE 256 // The size of the buffer used for receiving data over UART
 #define CLI_TX_BUFFER_SIZE 256 // The size of the buffer used for transmitting data over UART
-#define CLI_QUEUE_LENGTH 10    // The size of the queue used for holding incoming and outgoing data
+#define CLI_QUEUE_LENGTH 10    // The size of the queue used for holding outgoing data
+#define CLI_RX_QUEUE_LENGTH 64 // The size of the queue used for holding incoming data
+
+#define CLI_FLOW_NONE 0                 // No flow control, overrun lines are discarded whole
+#define CLI_FLOW_XONXOFF 1              // Software flow control, needs a full-duplex transport
+#define CLI_FLOW_RTS 2                  // Hardware flow control on CLI_RTS_PIN (depends on your project setup)
+#define CLI_FLOW_CONTROL CLI_FLOW_NONE  // Flow control of the RX direction, the RS-485 service port has no RTS line
+#define CLI_RX_HIGH_WATERMARK 48        // Characters waiting in the RX queue at which the host is asked to stop
+#define CLI_RX_LOW_WATERMARK 16         // Characters waiting in the RX queue at which the host may resume
+
+#define CLI_BUS_ADDRESSING 0            // If 1, only lines starting with "@<address> " or "@* " are accepted (multi-drop RS-485)
+#define CLI_BUS_ADDRESS 1               // Default address of this unit on the bus, 1 to 255
+#define CLI_BROADCAST_SLOT_MS 20        // Reply slot of each address after a broadcast line, longer than the longest broadcast reply
+
+#define CLI_RS485_GUARD_US 0            // Time the driver stays enabled after the last stop bit, in microseconds
+#define CLI_TURNAROUND_BUCKETS 8        // Number of buckets of the turnaround histogram, the last one collects the overflow
+#define CLI_TURNAROUND_BUCKET_US 5      // Width of a bucket of the turnaround histogram, in microseconds
+// #define CLI_GET_TIME_US()            // Free-running microsecond counter, define to enable the turnaround histogram
+
+#define CLI_TASK_STACK_SIZE 160             // Stack of the interactive CLI task (line input and authentication only), in words
+#define CLI_TASK_PRIORITY 3                 // Priority of the CLI task and of the command workers
+#define CLI_WORKER_COUNT 2                  // Number of command worker stack classes
+#define CLI_WORKER_STACK_SIZES {192, 384}   // Stack of each worker class, in words, smallest first; one worker exists at a time
+#define CLI_ARENA_SIZE 512                  // Scratch arena available to each command invocation, in bytes
+#define CLI_SESSION_TIMEOUT_MS 300000       // Inactivity after which an authenticated session is logged out, 0 to disable
 
 #define CLI_END_CHAR 0x0D  // The character for completing the command input (Carriage Return, CR)
 #define CLI_BS_CHAR 0x7F   // ASCII Backspace character code (deleting the last entered character)
 #define CLI_NULL_CHAR 0x00 // ASCII code of the null Character (Null Character, '\\0')
+#define CLI_CAN_CHAR 0x18  // ASCII Cancel character code, queued in place of the end of a line lost to an overrun
+#define CLI_XON_CHAR 0x11  // ASCII DC1, asks the host to resume sending
+#define CLI_XOFF_CHAR 0x13 // ASCII DC3, asks the host to stop sending
+#define CLI_STX_CHAR 0x02  // ASCII Start of Text, queued in front of a broadcast line
+#define CLI_ADDRESS_CHAR '@'   // Starts the address prefix of a line
+#define CLI_BROADCAST_CHAR '*' // Address of a line sent to all units
+#define CLI_REQUEST_ID_CHAR '%' // Starts the request ID prefix of a line, "%<id> <command>"
 
 #define PASSWORD "1234"
 #define PROMPT_PASSWORD "Enter password:"
 #define AUTH_SUCCESS "Authentication is successfull!\n"
 #define AUTH_FAIL "Authentication error. Try again.\n"
+#define SESSION_TIMEOUT "\nSession timed out.\n"
+#define INPUT_OVERRUN "\nInput overrun, line discarded.\n"
+#define OUT_OF_MEMORY "\nNo memory for a command worker, line discarded.\n"
 
 //========================================================[DATA TYPES DEFINITIONS]=========================================================================================================//
 
@@ -89,6 +132,21 @@ typedef enum
     CLI_MSG_ERR = 2      // UART transmission error occurred
 } CliTxStatus_e;
 
+/**
+ * @brief Enumeration for the states of the address filter of the RX callback.
+ *
+ * In addressed mode every line starts with "@<address> " or "@* ". The filter
+ * reads the prefix as it arrives and either accepts or drops the rest of the
+ * line, so lines for other units never reach the CLI task.
+ */
+typedef enum
+{
+    CLI_RX_LINE_START = 0, // Waiting for the first character of a line
+    CLI_RX_ADDRESS,        // Reading the address prefix
+    CLI_RX_ACCEPT,         // The line is for this unit
+    CLI_RX_DISCARD         // The line is for another unit, or has no valid prefix
+} Cli_RxAddressState_e;
+
 /**
  * @brief Enumeration for authentication FSM states.
  *
@@ -105,6 +163,24 @@ typedef enum
     FSM_ERR = 4,     // Error (incorrect password)
 } FSMAuthState_e;
 
+/**
+ * @brief Structure representing a command worker.
+ *
+ * Commands are executed by workers rather than by the CLI task itself.
+ * Each worker has its own stack size, and a command runs in the smallest
+ * worker that satisfies its declared usStackDepth. Only one worker exists
+ * at a time: the smallest one, replaced by a larger one while a command
+ * that needs its stack class runs.
+ */
+typedef struct
+{
+    TaskHandle_t taskHandle;          // Worker task handle, NULL if the worker was not created
+    uint16_t stackDepth;              // Stack size of the worker, in words
+    const char *command;              // Command line the worker has to execute
+    CLI_Definition_List_Item_t *item; // Registered command matched by the command line, NULL if none
+    int16_t job;                      // Scheduled job the worker has to execute, -1 to execute the command line
+} Cli_Worker_s;
+
 /**
  * @brief Structure representing the CLI instance.
  *
@@ -120,9 +196,40 @@ typedef struct
     char rxBuffer[CLI_RX_BUFFER_SIZE];   // Buffer for storing received data
     char txBuffer[CLI_TX_BUFFER_SIZE];   // Buffer for storing data to be transmitted
     uint16_t rxIndex;                    // Index for tracking position in the receive buffer
-    char rxChar;                         // Variable to store received character
+    char rxChar;                         // Character being processed by the CLI task
     char txChar;                         // Variable to store transmitted character
     FSMAuthState_e authState;            // Authentication state (used for managing user login)
+    CLI_Command_Context_t cmdContext;    // State of the command being executed in this session
+    uint8_t arena[CLI_ARENA_SIZE];       // Scratch memory of the command being executed, released when it completes
+    Cli_Worker_s workers[CLI_WORKER_COUNT]; // Command workers, smallest stack first
+    uint32_t wakeups;                    // Number of times the CLI task and the workers have been unblocked
+    bool requestTagged;                  // The command being executed was prefixed with a request ID
+    uint32_t requestId;                  // Request ID of the command being executed
+    TimerHandle_t sessionTimer;          // One-shot timer logging out an inactive session
+    volatile bool logoutPending;         // Set by the session timer, handled by the CLI task
+    volatile bool rxDiscarding;          // The RX queue overflowed, the rest of the line is dropped
+    volatile bool rxThrottled;           // The host has been asked to stop sending
+    volatile uint32_t rxDroppedLines;    // Number of lines discarded because of an RX overrun
+    volatile bool txHoldBus;             // More output follows, the driver stays enabled after the current transmission
+#ifdef CLI_GET_TIME_US
+    volatile uint32_t turnaround[CLI_TURNAROUND_BUCKETS]; // Histogram of the time from TX complete to the driver released
+#endif
+#if (CLI_BUS_ADDRESSING == 1)
+    uint8_t busAddress;                  // Address of this unit on the bus
+    Cli_RxAddressState_e rxAddressState; // State of the address filter of the RX callback
+    uint16_t rxAddress;                  // Address being read from the line prefix
+    bool rxBroadcast;                    // The line being received is a broadcast
+    volatile TickType_t broadcastTick;   // Time the last broadcast line was received
+    bool slotPending;                    // The reply to the current line has to wait for this unit's slot
+#endif
+#if (CLI_FLOW_CONTROL == CLI_FLOW_XONXOFF)
+    volatile bool txBusy;                // Output of the CLI task is being transmitted
+    volatile bool flowCharInFlight;      // XON or XOFF is being transmitted
+    volatile bool flowCharPending;       // XON or XOFF has to be transmitted once the output is sent
+    char flowChar;                       // Last flow control character requested
+    const uint8_t *txPendingData;        // Output deferred until the flow control character is sent
+    uint16_t txPendingLength;            // Length of the deferred output, 0 if none
+#endif
 } Cli_s;
 
 //===========================================================[PUBLIC INTERFACE]============================================================================================================//
@@ -140,4 +247,62 @@ typedef struct
  */
 int16_t CliStartup(void);
 
+/**
+ * @brief Returns the number of times the CLI has woken up.
+ *
+ * The CLI task and the command workers only block on events (a received
+ * character, a completed transmission or a command line), so while the console
+ * is idle this count does not change. Sampling it twice gives the wakeup rate
+ * of the CLI, which should be zero when nothing is typed.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return uint32_t - Number of wakeups since startup.
+ */
+uint32_t CliGetWakeupCount(void);
+
+/**
+ * @brief Returns the number of input lines discarded because of an RX overrun.
+ *
+ * When the RX queue is full, the rest of the line is dropped in the interrupt
+ * and the CLI task discards its beginning, so a line is either executed whole
+ * or not at all.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return uint32_t - Number of lines discarded since startup.
+ */
+uint32_t CliGetDroppedLineCount(void);
+
+#ifdef CLI_GET_TIME_US
+/**
+ * @brief Copies the histogram of the bus turnaround time.
+ *
+ * Bucket N counts the transmissions after which the driver was released
+ * between N * CLI_TURNAROUND_BUCKET_US and (N + 1) * CLI_TURNAROUND_BUCKET_US
+ * microseconds after the TX complete interrupt, guard time included. The last
+ * bucket also counts every longer turnaround.
+ *
+ * \param[in]  none;
+ * \param[out] buckets - Array of CLI_TURNAROUND_BUCKETS counters;
+ * \return none.
+ */
+void CliGetTurnaroundHistogram(uint32_t *buckets);
+#endif
+
+#if (CLI_BUS_ADDRESSING == 1)
+/**
+ * @brief Sets the address of this unit on the bus.
+ *
+ * Takes effect from the next line. Also selects the reply slot after a
+ * broadcast line: the unit at address N replies (N - 1) slots after the end
+ * of the line, so the units of a bus never reply at the same time.
+ *
+ * \param[in]  address - Address of this unit, 1 to 255;
+ * \param[out] none;
+ * \return none.
+ */
+void CliSetBusAddress(uint8_t address);
+#endif
+
 #endif /* CLI_H */
\ No newline at end of file
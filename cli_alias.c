@@ -0,0 +1,981 @@
+/**
+ * @file cli_alias.c
+ * @brief Implementation of the "alias", "macro" and "unalias" commands.
+ *
+ * @details
+ * Every alias and macro is run by one registered command whose name list is
+ * the names of all the definitions, rebuilt whenever one is added or removed.
+ *
+ * When a definition is made, its expansion is split into words, each either a
+ * slice of the expansion or a parameter number, and its command is resolved to
+ * its list item. An invocation builds the expanded line from the words and
+ * runs it in a context nested in its own, like "time" does, through
+ * FreeRTOS_CLIProcessResolvedCommand(), after one integer compare of the
+ * number of parameters.
+ *
+ * The committed definitions are read from the configuration store on first
+ * use rather than at startup, as mounting the store and resolving their
+ * commands loads command groups: by the first alias command, or through a
+ * stub standing for unknown names by the first name no command matches.
+ *
+ * @date Created on 17.10.2026
+ * @author Yauheni Bialkou
+ */
+
+//======================================================================[ INCLUDE ]======================================================================================================== //
+
+#include "cli_alias.h"
+#include "task.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+
+#if (CLI_ALIAS_COUNT > 0)
+
+//======================================================================[ INTERNAL MACRO DEFENITIONS ]===================================================================================== //
+
+#define CLI_ALIAS_ARENA_MARGIN 8U                                             // Arena bytes kept back for the alignment of the nested command's arena
+#define CLI_ALIAS_NAMES_SIZE (CLI_ALIAS_COUNT * (CLI_ALIAS_MAX_NAME_LENGTH + 1)) // Size of the list of names, one space or terminator per name
+#define CLI_ALIAS_PARAMETER_CHAR '$'                                          // Marks a parameter of a macro, followed by its number
+
+//======================================================================[ INTERNAL DATA TYPES DEFINITIONS ]================================================================================ //
+
+/**
+ * @brief One word of an expansion.
+ */
+typedef struct
+{
+    uint8_t offset;    // Offset of the word in the expansion
+    uint8_t length;    // Length of the word
+    uint8_t parameter; // Number of the parameter the word stands for, 0 for a literal word
+} CliAliasWord_s;
+
+/**
+ * @brief One alias or macro.
+ */
+typedef struct
+{
+    char name[CLI_ALIAS_MAX_NAME_LENGTH + 1];  // Name, empty if the entry is free
+    char text[CLI_ALIAS_MAX_LENGTH + 1];       // Expansion, words separated by single spaces
+    CLI_Definition_List_Item_t *command;       // Command the expansion runs
+    CliAliasWord_s words[CLI_ALIAS_MAX_WORDS]; // Words of the expansion, the command first
+    uint8_t wordCount;                         // Number of words of the expansion
+    uint8_t parameterCount;                    // Number of parameters a macro takes
+    bool macro;                                // The entry is a macro rather than an alias
+} CliAliasEntry_s;
+
+/**
+ * @brief State of an invocation, kept in its arena between calls.
+ */
+typedef struct
+{
+    CLI_Command_Context_t context;       // Context of the expanded command
+    CLI_Definition_List_Item_t *command; // Command the expansion runs
+    char line[];                         // Expanded command line
+} CliAliasRun_s;
+
+/**
+ * @brief Structure holding the alias state.
+ */
+typedef struct
+{
+    CliAliasEntry_s entries[CLI_ALIAS_COUNT]; // Aliases and macros
+    char names[CLI_ALIAS_NAMES_SIZE];         // Names of all the entries, the command list of cliAliasRunDefinition
+    bool store;                               // The configuration store is mounted, definitions are staged in it
+    bool loaded;                              // The committed definitions have been read
+    bool loading;                             // The committed definitions are being read
+} CliAlias_s;
+
+//======================================================================[ INTERNAL FUNCTIONS AND OBJECTS DECLARATION ]===================================================================== //
+
+static CliAlias_s cliAlias = {0}; // Alias state
+
+/**
+ * @brief Command callback function for the "alias" and "macro" commands.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the name and the expansion;
+ * \return     pdTRUE if more output follows, otherwise pdFALSE.
+ */
+static BaseType_t cliAliasDefineCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
+
+/**
+ * @brief Command callback function for the "unalias" command.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the name;
+ * \return     pdFALSE (indicates that the output has been fully written).
+ */
+static BaseType_t cliUnaliasCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
+
+/**
+ * @brief Command callback function for the aliases and macros themselves.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the name and the parameters;
+ * \return     pdTRUE if more output follows, otherwise pdFALSE.
+ */
+static BaseType_t cliAliasRunCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
+
+/**
+ * @brief Writes as many definitions as fit into the output buffer.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \return     pdTRUE if more definitions follow, otherwise pdFALSE.
+ */
+static BaseType_t cliAliasList(char *pcWriteBuffer, size_t xWriteBufferLen);
+
+/**
+ * @brief Loader of the stub standing for the names of the committed definitions.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string that loads the stub;
+ * \return     pdPASS, or pdFAIL while the definitions are being read.
+ */
+static BaseType_t cliAliasLoadStub(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
+
+/**
+ * @brief Reads the committed definitions from the configuration store, once.
+ *
+ * \param[in]  none;
+ * \return     none.
+ */
+static void cliAliasLoad(void);
+
+/**
+ * @brief Splits an expansion into words, resolves its command and stores it.
+ *
+ * \param[in]  name            - Name of the definition;
+ * \param[in]  nameLength      - Length of the name;
+ * \param[in]  text            - Null-terminated expansion;
+ * \param[in]  macro           - The definition is a macro;
+ * \param[out] pcWriteBuffer   - Buffer receiving the error message of a command group that fails to load;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \return     int16_t - CLI_ALIAS_OK on success, negative CliAliasStatus_e value on failure.
+ */
+static int16_t cliAliasDefine(const char *name, size_t nameLength, const char *text, bool macro, char *pcWriteBuffer, size_t xWriteBufferLen);
+
+/**
+ * @brief Finds the entry of a name.
+ *
+ * \param[in]  name       - Name to find;
+ * \param[in]  nameLength - Length of the name;
+ * \return     CliAliasEntry_s * - The entry, or NULL if the name is not defined.
+ */
+static CliAliasEntry_s *cliAliasFind(const char *name, size_t nameLength);
+
+/**
+ * @brief Finds the entry an invocation runs.
+ *
+ * \param[in]  pcCommandString - Command string of the invocation;
+ * \return     const CliAliasEntry_s * - The entry, or NULL if no name matches.
+ */
+static const CliAliasEntry_s *cliAliasMatch(const char *pcCommandString);
+
+/**
+ * @brief Writes the expanded command line of an invocation.
+ *
+ * \param[in]  entry           - Entry invoked;
+ * \param[in]  pcCommandString - Command string of the invocation;
+ * \param[out] line            - Buffer receiving the null-terminated line, or NULL to only measure it;
+ * \return     size_t - Length of the line.
+ */
+static size_t cliAliasExpand(const CliAliasEntry_s *entry, const char *pcCommandString, char *line);
+
+/**
+ * @brief Rebuilds the list of names the aliases and macros are run by.
+ *
+ * \param[in]  none;
+ * \return     none.
+ */
+static void cliAliasUpdateNames(void);
+
+/**
+ * @brief Command definitions of the alias commands.
+ */
+static const CLI_Command_Definition_t cliAliasDefinitions[] =
+    {
+        {
+            .pcCommand = "alias",
+            .pcHelpString = "alias [<name> <command...>] - lists the aliases and macros, or makes name run command followed by its parameters \r\n",
+            .pxCommandInterpreter = cliAliasDefineCommand,
+            .cExpectedNumberOfParameters = -1,
+        },
+        {
+            .pcCommand = "macro",
+            .pcHelpString = "macro <name> <command...> - makes name run command with $1 to $9 replaced by its parameters \r\n",
+            .pxCommandInterpreter = cliAliasDefineCommand,
+            .cExpectedNumberOfParameters = -1,
+        },
+        {
+            .pcCommand = "unalias",
+            .pcHelpString = "unalias <name> - removes an alias or macro \r\n",
+            .pxCommandInterpreter = cliUnaliasCommand,
+            .cExpectedNumberOfParameters = 1,
+        },
+        {
+            .pcCommand = cliAlias.names,
+            .pcHelpString = "<alias|macro> [<parameters>] - runs the command of an alias or macro \r\n",
+            .pxCommandInterpreter = cliAliasRunCommand,
+            .cExpectedNumberOfParameters = -1,
+            .ucFlags = cliCOMMAND_FLAG_NAMES,
+            .usStackDepth = 384, // The expanded command runs nested on the same stack
+        }};
+
+static const CLI_Command_Definition_t *const cliAliasRunDefinition = &cliAliasDefinitions[3]; // Definition running every alias and macro
+
+/**
+ * @brief Stub standing for the names of the committed definitions until they are read.
+ */
+static const CLI_Command_Definition_t cliAliasStubDefinition =
+    {
+        .pcCommand = "",
+        .pcHelpString = "",
+        .pxCommandInterpreter = cliAliasLoadStub,
+        .cExpectedNumberOfParameters = -1,
+        .ucFlags = cliCOMMAND_FLAG_GROUP | cliCOMMAND_FLAG_UNKNOWN,
+        .usStackDepth = 384, // A committed definition runs its command nested on the same stack
+};
+
+//=======================================================================[PUBLIC INTERFACE FUNCTIONS]===================================================================================== //
+
+/**
+ * @brief Registers the "alias", "macro" and "unalias" commands with FreeRTOS CLI.
+ *
+ * The committed definitions are not read here but when first needed, so no
+ * command group is loaded at startup.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return int16_t - 0 on success, negative value on error.
+ */
+int16_t CliAliasCmdInit(void)
+{
+    int16_t status = 0;
+
+    for (size_t ind = 0; ind < (sizeof(cliAliasDefinitions) / sizeof(cliAliasDefinitions[0])); ind++)
+    {
+        if (FreeRTOS_CLIRegisterCommand(&cliAliasDefinitions[ind]) != pdPASS)
+        {
+            status = -1;
+        }
+    }
+
+    if (FreeRTOS_CLIRegisterCommand(&cliAliasStubDefinition) != pdPASS)
+    {
+        status = -1;
+    }
+
+    return status;
+}
+
+//=====================================================================[ PRIVATE FUNCTIONS ]============================================================================================== //
+
+/**
+ * @brief Command callback function for the "alias" and "macro" commands.
+ *
+ * A new definition is staged in the configuration store, which must be
+ * committed for it to survive a reset. A definition replaces the one with the
+ * same name.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the name and the expansion;
+ * \return     pdTRUE if more output follows, otherwise pdFALSE.
+ */
+static BaseType_t cliAliasDefineCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString)
+{
+    bool macro = (FreeRTOS_CLIMatchName(cliAliasDefinitions[1].pcCommand, pcCommandString) != cliMATCH_NONE);
+    const char *helpString = cliAliasDefinitions[macro ? 1 : 0].pcHelpString;
+    BaseType_t nameLength = 0;
+    const char *name = FreeRTOS_CLIGetParameter(pcCommandString, 1, &nameLength);
+    char key[CLI_CONFIG_MAX_KEY_LENGTH + 1] = {0};
+    int16_t status = CLI_ALIAS_OK;
+
+    if ((pcWriteBuffer == NULL) ||
+        (xWriteBufferLen == 0))
+    {
+        return pdFALSE;
+    }
+
+    /* A definition replaces or lists the committed ones, which must be known first */
+    cliAliasLoad();
+
+    if ((name == NULL) &&
+        !macro)
+    {
+        return cliAliasList(pcWriteBuffer, xWriteBufferLen);
+    }
+
+    /* The expansion is the rest of the line after the name */
+    const char *text = (name != NULL) ? (name + nameLength) : "";
+
+    while (*text == ' ')
+    {
+        text++;
+    }
+
+    if (*text == '\0')
+    {
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_PARAMETER_COUNT, helpString);
+        FreeRTOS_CLISetStatus(cliSTATUS_BAD_PARAMETERS);
+        return pdFALSE;
+    }
+
+    CliAliasEntry_s *previous = cliAliasFind(name, (size_t)nameLength);
+    bool wasMacro = (previous != NULL) && previous->macro;
+
+    status = cliAliasDefine(name, (size_t)nameLength, text, macro, pcWriteBuffer, xWriteBufferLen);
+
+    if ((status == CLI_ALIAS_OK) &&
+        cliAlias.store)
+    {
+        const CliAliasEntry_s *entry = cliAliasFind(name, (size_t)nameLength);
+        int16_t staged = CLI_CONFIG_OK;
+
+        /* A definition of the other kind under the same name is replaced */
+        if ((previous != NULL) &&
+            (wasMacro != macro))
+        {
+            snprintf(key, sizeof(key), "%s.%s", wasMacro ? "macro" : "alias", entry->name);
+            staged = CliConfigSet(key, NULL);
+        }
+
+        if (staged == CLI_CONFIG_OK)
+        {
+            snprintf(key, sizeof(key), "%s.%s", macro ? "macro" : "alias", entry->name);
+            staged = CliConfigSet(key, entry->text);
+        }
+
+        if (staged != CLI_CONFIG_OK)
+        {
+            FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_PENDING_FULL, "Defined until reset, the configuration store cannot stage it\r\n");
+            FreeRTOS_CLISetStatus(cliSTATUS_FAILED);
+            return pdFALSE;
+        }
+    }
+
+    switch (status)
+    {
+    case CLI_ALIAS_OK:
+        snprintf(pcWriteBuffer, xWriteBufferLen, cliAlias.store ? "OK (commit to save)\r\n" : "OK (until reset)\r\n");
+        break;
+
+    case CLI_ALIAS_ERR_NAME:
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_INVALID_ARGUMENT, "Name is already a command\r\n");
+        break;
+
+    case CLI_ALIAS_ERR_COMMAND:
+        /* A command group that failed to load has written its own message */
+        if (FreeRTOS_CLIGetOutputLength(pcWriteBuffer) == 0)
+        {
+            FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_UNKNOWN_COMMAND, NULL);
+        }
+        break;
+
+    case CLI_ALIAS_ERR_RECURSIVE:
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_INVALID_ARGUMENT, "An expansion cannot run an alias or macro command\r\n");
+        break;
+
+    case CLI_ALIAS_ERR_FULL:
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_FULL, "No alias entry left\r\n");
+        break;
+
+    default:
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_INVALID_ARGUMENT, helpString);
+        break;
+    }
+
+    if (status < 0)
+    {
+        FreeRTOS_CLISetStatus(cliSTATUS_FAILED);
+    }
+
+    return pdFALSE;
+}
+
+/**
+ * @brief Command callback function for the "unalias" command.
+ *
+ * The removal is staged in the configuration store first, so a definition is
+ * only removed if its removal can be committed.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the name;
+ * \return     pdFALSE (indicates that the output has been fully written).
+ */
+static BaseType_t cliUnaliasCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString)
+{
+    BaseType_t nameLength = 0;
+    const char *name = FreeRTOS_CLIGetParameter(pcCommandString, 1, &nameLength);
+    CliAliasEntry_s *entry = NULL;
+    char key[CLI_CONFIG_MAX_KEY_LENGTH + 1] = {0};
+
+    if ((pcWriteBuffer == NULL) ||
+        (xWriteBufferLen == 0))
+    {
+        return pdFALSE;
+    }
+
+    cliAliasLoad();
+    entry = cliAliasFind(name, (size_t)nameLength);
+
+    if (entry == NULL)
+    {
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_NOT_FOUND, "Alias not found\r\n");
+        FreeRTOS_CLISetStatus(cliSTATUS_FAILED);
+        return pdFALSE;
+    }
+
+    snprintf(key, sizeof(key), "%s.%s", entry->macro ? "macro" : "alias", entry->name);
+
+    if (cliAlias.store &&
+        (CliConfigSet(key, NULL) != CLI_CONFIG_OK))
+    {
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_PENDING_FULL, NULL);
+        FreeRTOS_CLISetStatus(cliSTATUS_FAILED);
+        return pdFALSE;
+    }
+
+    entry->name[0] = '\0';
+    cliAliasUpdateNames();
+
+    snprintf(pcWriteBuffer, xWriteBufferLen, cliAlias.store ? "OK (commit to save)\r\n" : "OK\r\n");
+
+    return pdFALSE;
+}
+
+/**
+ * @brief Command callback function for the aliases and macros themselves.
+ *
+ * The expanded line is built in the arena on the first call. Its output is
+ * passed through chunk by chunk and its exit status becomes the invocation's.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the name and the parameters;
+ * \return     pdTRUE if more output follows, otherwise pdFALSE.
+ */
+static BaseType_t cliAliasRunCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString)
+{
+    CLI_Command_Context_t *outerContext = FreeRTOS_CLIGetContext();
+    CliAliasRun_s *state = (CliAliasRun_s *)outerContext->pvCursor;
+    BaseType_t length = 0;
+
+    if ((pcWriteBuffer == NULL) ||
+        (xWriteBufferLen == 0))
+    {
+        return pdFALSE;
+    }
+
+    if (state == NULL)
+    {
+        const CliAliasEntry_s *entry = cliAliasMatch(pcCommandString);
+        uint8_t parameters = 0;
+
+        if (entry == NULL)
+        {
+            FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_UNKNOWN_COMMAND, NULL);
+            FreeRTOS_CLISetStatus(cliSTATUS_NOT_FOUND);
+            return pdFALSE;
+        }
+
+        while (FreeRTOS_CLIGetParameter(pcCommandString, parameters + 1U, &length) != NULL)
+        {
+            parameters++;
+        }
+
+        /* The words of the expansion were counted when it was defined */
+        int8_t expected = entry->command->pxCommandLineDefinition->cExpectedNumberOfParameters;
+        uint8_t words = (uint8_t)(entry->wordCount - 1U + (entry->macro ? 0U : parameters));
+
+        if ((entry->macro && (parameters != entry->parameterCount)) ||
+            ((expected >= 0) && (words != (uint8_t)expected)))
+        {
+            FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_PARAMETER_COUNT, NULL);
+            FreeRTOS_CLISetStatus(cliSTATUS_BAD_PARAMETERS);
+            return pdFALSE;
+        }
+
+        state = FreeRTOS_CLIArenaAlloc(sizeof(CliAliasRun_s) + cliAliasExpand(entry, pcCommandString, NULL) + 1U);
+        if (state == NULL)
+        {
+            FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_FULL, NULL);
+            FreeRTOS_CLISetStatus(cliSTATUS_FAILED);
+            return pdFALSE;
+        }
+
+        (void)cliAliasExpand(entry, pcCommandString, state->line);
+        state->command = entry->command;
+        outerContext->pvCursor = state;
+
+        /* The expanded command gets the rest of the arena and the session's settings */
+        size_t arenaSize = outerContext->xArenaSize - outerContext->xArenaUsed;
+        void *arena = (arenaSize > CLI_ALIAS_ARENA_MARGIN) ? FreeRTOS_CLIArenaAlloc(arenaSize - CLI_ALIAS_ARENA_MARGIN) : NULL;
+
+        FreeRTOS_CLIInitContext(&state->context, arena, (arena != NULL) ? (arenaSize - CLI_ALIAS_ARENA_MARGIN) : 0U);
+        state->context.ucVerbosity = outerContext->ucVerbosity;
+        state->context.ucFormat = outerContext->ucFormat;
+        state->context.ucNesting = outerContext->ucNesting;
+    }
+
+    FreeRTOS_CLISetContext(&state->context);
+    BaseType_t more = FreeRTOS_CLIProcessResolvedCommand(state->command, state->line, pcWriteBuffer, xWriteBufferLen);
+    FreeRTOS_CLISetContext(outerContext);
+
+    /* The chunk may be binary records */
+    outerContext->xOutputLength = state->context.xOutputLength;
+
+    if (more == pdFALSE)
+    {
+        FreeRTOS_CLISetStatus(state->context.xStatus);
+    }
+
+    return more;
+}
+
+/**
+ * @brief Loader of the stub standing for the names of the committed definitions.
+ *
+ * The stub is loaded by the first name no registered command matches, which
+ * may be a committed definition. Resolving the commands of the definitions
+ * while they are read comes back here for a name that is still unknown, which
+ * must then stay unknown.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string that loads the stub;
+ * \return     pdPASS, or pdFAIL while the definitions are being read.
+ */
+static BaseType_t cliAliasLoadStub(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString)
+{
+    (void)pcWriteBuffer;
+    (void)xWriteBufferLen;
+    (void)pcCommandString;
+
+    if (cliAlias.loading)
+    {
+        return pdFAIL;
+    }
+
+    cliAliasLoad();
+
+    return pdPASS;
+}
+
+/**
+ * @brief Reads the committed definitions from the configuration store, once.
+ *
+ * The configuration store is mounted by resolving the "config" command, which
+ * loads its command group once for everyone. Committed definitions that no
+ * longer resolve, for example because their command was removed from the
+ * firmware, are skipped.
+ *
+ * \param[in]  none;
+ * \return     none.
+ */
+static void cliAliasLoad(void)
+{
+    char message[CLI_ALIAS_MAX_LENGTH + 1] = {0};
+    char key[CLI_CONFIG_MAX_KEY_LENGTH + 1] = {0};
+    char value[CLI_CONFIG_MAX_VALUE_LENGTH + 1] = {0};
+    uint16_t cursor = 0;
+
+    if (cliAlias.loaded)
+    {
+        return;
+    }
+
+    cliAlias.loaded = true;
+    cliAlias.loading = true;
+
+    /* Without the store the definitions only last until reset */
+    cliAlias.store = (FreeRTOS_CLIResolveCommand("config", message, sizeof(message)) != NULL);
+
+    while (cliAlias.store &&
+           (CliConfigGetNext(&cursor, key, value) == CLI_CONFIG_OK))
+    {
+        bool macro = (strncmp(key, "macro.", 6) == 0);
+
+        if (macro ||
+            (strncmp(key, "alias.", 6) == 0))
+        {
+            (void)cliAliasDefine(&key[6], strlen(&key[6]), value, macro, message, sizeof(message));
+        }
+    }
+
+    cliAlias.loading = false;
+}
+
+/**
+ * @brief Writes as many definitions as fit into the output buffer.
+ *
+ * The index of the next entry is kept in the command context between calls.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \return     pdTRUE if more definitions follow, otherwise pdFALSE.
+ */
+static BaseType_t cliAliasList(char *pcWriteBuffer, size_t xWriteBufferLen)
+{
+    CLI_Command_Context_t *context = FreeRTOS_CLIGetContext();
+    bool firstChunk = (context->uxIndex == 0);
+    bool found = false;
+    CLI_Record_t record;
+
+    FreeRTOS_CLIRecordInit(&record, pcWriteBuffer, xWriteBufferLen);
+
+    for (; context->uxIndex < CLI_ALIAS_COUNT; context->uxIndex++)
+    {
+        const CliAliasEntry_s *entry = &cliAlias.entries[context->uxIndex];
+
+        if (entry->name[0] == '\0')
+        {
+            continue;
+        }
+
+        FreeRTOS_CLIRecordBegin(&record);
+        FreeRTOS_CLIRecordString(&record, "name", entry->name);
+        FreeRTOS_CLIRecordString(&record, "kind", entry->macro ? "macro" : "alias");
+        FreeRTOS_CLIRecordString(&record, "command", entry->text);
+
+        if ((FreeRTOS_CLIRecordEnd(&record) != pdPASS) &&
+            (FreeRTOS_CLIRecordLength(&record) != 0))
+        {
+            /* The record does not fit, send it with the next chunk */
+            return pdTRUE;
+        }
+
+        found = true;
+    }
+
+    if (firstChunk &&
+        !found &&
+        (FreeRTOS_CLIGetFormat() == cliFORMAT_TEXT))
+    {
+        snprintf(pcWriteBuffer, xWriteBufferLen, "No aliases\r\n");
+    }
+
+    return pdFALSE;
+}
+
+/**
+ * @brief Splits an expansion into words, resolves its command and stores it.
+ *
+ * The definition replaces the one with the same name. It is rejected, leaving
+ * the definitions unchanged, if its name is the name of a command or if its
+ * command is not registered or is one of the alias commands, which also
+ * keeps aliases from expanding into each other.
+ *
+ * \param[in]  name            - Name of the definition;
+ * \param[in]  nameLength      - Length of the name;
+ * \param[in]  text            - Null-terminated expansion;
+ * \param[in]  macro           - The definition is a macro;
+ * \param[out] pcWriteBuffer   - Buffer receiving the error message of a command group that fails to load;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \return     int16_t - CLI_ALIAS_OK on success, negative CliAliasStatus_e value on failure.
+ */
+static int16_t cliAliasDefine(const char *name, size_t nameLength, const char *text, bool macro, char *pcWriteBuffer, size_t xWriteBufferLen)
+{
+    CliAliasEntry_s parsed = {0};
+    CliAliasEntry_s *entry = cliAliasFind(name, nameLength);
+    size_t length = 0;
+
+    if ((nameLength == 0) ||
+        (nameLength > CLI_ALIAS_MAX_NAME_LENGTH) ||
+        (strlen(text) > CLI_ALIAS_MAX_LENGTH))
+    {
+        return CLI_ALIAS_ERR_INVALID;
+    }
+
+    /* Keep the words separated by single spaces, as the command line is */
+    while (*text != '\0')
+    {
+        size_t wordLength = strcspn(text, " ");
+
+        if (wordLength == 0)
+        {
+            text++;
+            continue;
+        }
+
+        if (parsed.wordCount == CLI_ALIAS_MAX_WORDS)
+        {
+            return CLI_ALIAS_ERR_INVALID;
+        }
+
+        if (length != 0)
+        {
+            parsed.text[length++] = ' ';
+        }
+
+        CliAliasWord_s *word = &parsed.words[parsed.wordCount++];
+
+        word->offset = (uint8_t)length;
+        word->length = (uint8_t)wordLength;
+        memcpy(&parsed.text[length], text, wordLength);
+
+        if (macro &&
+            (text[0] == CLI_ALIAS_PARAMETER_CHAR))
+        {
+            if ((wordLength != 2) ||
+                (text[1] < '1') ||
+                (text[1] > '9'))
+            {
+                return CLI_ALIAS_ERR_INVALID;
+            }
+
+            word->parameter = (uint8_t)(text[1] - '0');
+            parsed.parameterCount = (word->parameter > parsed.parameterCount) ? word->parameter : parsed.parameterCount;
+        }
+
+        length += wordLength;
+        text += wordLength;
+    }
+
+    if ((parsed.wordCount == 0) ||
+        (parsed.words[0].parameter != 0))
+    {
+        return CLI_ALIAS_ERR_INVALID;
+    }
+
+    /* Checked by name before resolving, as resolving a name can load its command group */
+    for (size_t ind = 0; ind < (sizeof(cliAliasDefinitions) / sizeof(cliAliasDefinitions[0])); ind++)
+    {
+        const char *command = cliAliasDefinitions[ind].pcCommand;
+
+        if ((command != cliAlias.names) &&
+            (strlen(command) == nameLength) &&
+            (strncmp(command, name, nameLength) == 0))
+        {
+            return CLI_ALIAS_ERR_NAME;
+        }
+
+        if ((command != cliAlias.names) &&
+            (strlen(command) == parsed.words[0].length) &&
+            (strncmp(command, parsed.text, parsed.words[0].length) == 0))
+        {
+            return CLI_ALIAS_ERR_RECURSIVE;
+        }
+    }
+
+    /* A name that only abbreviates a command is allowed, typed in full it runs the alias */
+    CLI_Definition_List_Item_t *clash = (entry == NULL) ? FreeRTOS_CLIResolveCommand(name, pcWriteBuffer, xWriteBufferLen) : NULL;
+
+    if ((clash != NULL) &&
+        (FreeRTOS_CLIMatchName(clash->pxCommandLineDefinition->pcCommand, name) == cliMATCH_EXACT))
+    {
+        return CLI_ALIAS_ERR_NAME;
+    }
+
+    parsed.command = FreeRTOS_CLIResolveCommand(parsed.text, pcWriteBuffer, xWriteBufferLen);
+
+    if (parsed.command == NULL)
+    {
+        return CLI_ALIAS_ERR_COMMAND;
+    }
+
+    if (parsed.command->pxCommandLineDefinition == cliAliasRunDefinition)
+    {
+        return CLI_ALIAS_ERR_RECURSIVE;
+    }
+
+    for (size_t ind = 0; (entry == NULL) && (ind < CLI_ALIAS_COUNT); ind++)
+    {
+        if (cliAlias.entries[ind].name[0] == '\0')
+        {
+            entry = &cliAlias.entries[ind];
+        }
+    }
+
+    if (entry == NULL)
+    {
+        return CLI_ALIAS_ERR_FULL;
+    }
+
+    memcpy(parsed.name, name, nameLength);
+    parsed.macro = macro;
+    *entry = parsed;
+
+    cliAliasUpdateNames();
+
+    return CLI_ALIAS_OK;
+}
+
+/**
+ * @brief Finds the entry of a name.
+ *
+ * \param[in]  name       - Name to find;
+ * \param[in]  nameLength - Length of the name;
+ * \return     CliAliasEntry_s * - The entry, or NULL if the name is not defined.
+ */
+static CliAliasEntry_s *cliAliasFind(const char *name, size_t nameLength)
+{
+    if ((name == NULL) ||
+        (nameLength == 0) ||
+        (nameLength > CLI_ALIAS_MAX_NAME_LENGTH))
+    {
+        return NULL;
+    }
+
+    for (size_t ind = 0; ind < CLI_ALIAS_COUNT; ind++)
+    {
+        CliAliasEntry_s *entry = &cliAlias.entries[ind];
+
+        if ((strncmp(entry->name, name, nameLength) == 0) &&
+            (entry->name[nameLength] == '\0'))
+        {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Finds the entry an invocation runs.
+ *
+ * The name is matched by the interpreter's rules, so it may be abbreviated or
+ * in another case if the interpreter allows it. The interpreter has already
+ * rejected an abbreviation of several names.
+ *
+ * \param[in]  pcCommandString - Command string of the invocation;
+ * \return     const CliAliasEntry_s * - The entry, or NULL if no name matches.
+ */
+static const CliAliasEntry_s *cliAliasMatch(const char *pcCommandString)
+{
+    const CliAliasEntry_s *abbreviated = NULL;
+
+    for (size_t ind = 0; ind < CLI_ALIAS_COUNT; ind++)
+    {
+        const CliAliasEntry_s *entry = &cliAlias.entries[ind];
+        UBaseType_t match = (entry->name[0] != '\0') ? FreeRTOS_CLIMatchName(entry->name, pcCommandString) : cliMATCH_NONE;
+
+        if (match == cliMATCH_EXACT)
+        {
+            return entry;
+        }
+
+        if ((match == cliMATCH_PREFIX) &&
+            (abbreviated == NULL))
+        {
+            abbreviated = entry;
+        }
+    }
+
+    return abbreviated;
+}
+
+/**
+ * @brief Writes the expanded command line of an invocation.
+ *
+ * An alias is followed by all the parameters of the invocation; the words of a
+ * macro that stand for a parameter are replaced by that parameter.
+ *
+ * \param[in]  entry           - Entry invoked;
+ * \param[in]  pcCommandString - Command string of the invocation;
+ * \param[out] line            - Buffer receiving the null-terminated line, or NULL to only measure it;
+ * \return     size_t - Length of the line.
+ */
+static size_t cliAliasExpand(const CliAliasEntry_s *entry, const char *pcCommandString, char *line)
+{
+    size_t length = 0;
+    BaseType_t wordLength = 0;
+    const char *word = NULL;
+
+    for (uint8_t ind = 0; ind <= entry->wordCount; ind++)
+    {
+        if (ind == entry->wordCount)
+        {
+            /* The rest of the invocation follows an alias */
+            word = entry->macro ? NULL : FreeRTOS_CLIGetParameter(pcCommandString, 1, &wordLength);
+            if (word == NULL)
+            {
+                break;
+            }
+
+            wordLength = (BaseType_t)strlen(word);
+            while (word[wordLength - 1] == ' ')
+            {
+                wordLength--;
+            }
+        }
+        else if (entry->words[ind].parameter != 0)
+        {
+            word = FreeRTOS_CLIGetParameter(pcCommandString, entry->words[ind].parameter, &wordLength);
+        }
+        else
+        {
+            word = &entry->text[entry->words[ind].offset];
+            wordLength = entry->words[ind].length;
+        }
+
+        if (ind != 0)
+        {
+            if (line != NULL)
+            {
+                line[length] = ' ';
+            }
+            length++;
+        }
+
+        if (line != NULL)
+        {
+            memcpy(&line[length], word, (size_t)wordLength);
+        }
+        length += (size_t)wordLength;
+    }
+
+    if (line != NULL)
+    {
+        line[length] = '\0';
+    }
+
+    return length;
+}
+
+/**
+ * @brief Rebuilds the list of names the aliases and macros are run by.
+ *
+ * The list is the command of a registered definition, so it is rebuilt with
+ * the scheduler's critical section held, like the command list is changed.
+ *
+ * \param[in]  none;
+ * \return     none.
+ */
+static void cliAliasUpdateNames(void)
+{
+    size_t length = 0;
+
+    taskENTER_CRITICAL();
+
+    cliAlias.names[0] = '\0';
+
+    for (size_t ind = 0; ind < CLI_ALIAS_COUNT; ind++)
+    {
+        const char *name = cliAlias.entries[ind].name;
+
+        if (name[0] == '\0')
+        {
+            continue;
+        }
+
+        if (length != 0)
+        {
+            cliAlias.names[length++] = ' ';
+        }
+
+        strcpy(&cliAlias.names[length], name);
+        length += strlen(name);
+    }
+
+    taskEXIT_CRITICAL();
+}
+
+#endif /* CLI_ALIAS_COUNT */
@@ -0,0 +1,81 @@
+/**
+ * @file cli_alias.h
+ * @brief Command aliases and macros defined at run time.
+ *
+ * @details
+ * This file declares the "alias", "macro" and "unalias" commands.
+ *
+ * "alias <name> <command...>" makes <name> run <command...>, with the
+ * parameters given to the alias appended. "macro <name> <command...>" does the
+ * same, but the expansion refers to the parameters of the invocation as $1 to
+ * $9, and a macro must be given exactly as many parameters as it refers to:
+ *
+ *   macro gain adc cfg $1 gain $2 rate 1000
+ *   gain 3 16                               runs "adc cfg 3 gain 16 rate 1000"
+ *
+ * An expansion is split into words and its command is looked up once, when it
+ * is defined, so an invocation neither searches the list of commands nor
+ * counts the parameters of the expanded line again. The command of an
+ * expansion must already be registered and cannot be another alias or macro.
+ *
+ * Definitions are staged in the configuration store as "alias.<name>" and
+ * "macro.<name>" keys. Once committed they are defined again after a reset,
+ * by the first alias command or the first name no other command matches.
+ *
+ * @date Created on 17.10.2026
+ * @author Yauheni Bialkou
+ */
+
+#ifndef CLI_ALIAS_H
+#define CLI_ALIAS_H
+
+//================================================================[INCLUDE]================================================================================================================//
+
+#include "FreeRTOS.h"     // FreeRTOS kernel headers
+#include "FreeRTOS_CLI.h" // FreeRTOS CLI API
+#include "cli_config.h"   // Configuration store holding the definitions
+
+//===========================================================[MACRO DEFINITIONS]===========================================================================================================//
+
+#define CLI_ALIAS_COUNT 8                                // Number of aliases and macros that can be defined, 0 to disable them
+#define CLI_ALIAS_MAX_NAME_LENGTH 16                     // Maximum length of a name, in characters
+#define CLI_ALIAS_MAX_LENGTH CLI_CONFIG_MAX_VALUE_LENGTH // Maximum length of an expansion, in characters
+#define CLI_ALIAS_MAX_WORDS 16                           // Maximum number of words of an expansion
+
+//========================================================[DATA TYPES DEFINITIONS]=========================================================================================================//
+
+/**
+ * @brief Enumeration for alias statuses.
+ *
+ * Negative values are returned when a definition is rejected.
+ */
+typedef enum
+{
+    CLI_ALIAS_OK = 0,                // Operation successful
+    CLI_ALIAS_ERR_INVALID = -1,      // Name or expansion is too long, or refers to an invalid parameter
+    CLI_ALIAS_ERR_NAME = -2,         // The name is already the name of a command
+    CLI_ALIAS_ERR_COMMAND = -3,      // The command of the expansion is not registered
+    CLI_ALIAS_ERR_RECURSIVE = -4,    // The command of the expansion is an alias or macro command
+    CLI_ALIAS_ERR_FULL = -5          // No entry left for a new definition
+
+} CliAliasStatus_e;
+
+//===========================================================[PUBLIC INTERFACE]============================================================================================================//
+
+#if (CLI_ALIAS_COUNT > 0)
+
+/**
+ * @brief Registers the "alias", "macro" and "unalias" commands with FreeRTOS CLI.
+ *
+ * The committed aliases and macros are defined again when first needed, so
+ * the configuration store is not mounted at startup.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return int16_t - 0 on success, negative value on error.
+ */
+int16_t CliAliasCmdInit(void);
+
+#endif /* CLI_ALIAS_COUNT */
+
+#endif /* CLI_ALIAS_H */
@@ -0,0 +1,426 @@
+/**
+ * @file cli_bench.c
+ * @brief Implementation of the "time" and "bench" commands.
+ *
+ * @details
+ * Both commands run the measured command in a context nested in their own,
+ * like a script does, with the rest of their scratch arena as its arena.
+ *
+ * "time" hands each chunk of the measured command's output back to the
+ * console as its own. The time between returning a chunk and being called
+ * again is what the console took to transmit it.
+ *
+ * "bench" needs the 99th percentile without keeping every sample: only the
+ * largest runs that can still be it are kept, which for n runs is about n / 100
+ * samples, so even the largest benches fit in the arena.
+ *
+ * @date Created on 17.10.2026
+ * @author Yauheni Bialkou
+ */
+
+//======================================================================[ INCLUDE ]======================================================================================================== //
+
+#include "cli_bench.h"
+#include "task.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#if (configCOMMAND_INT_USE_STATS == 1)
+
+//======================================================================[ INTERNAL MACRO DEFENITIONS ]===================================================================================== //
+
+#define CLI_BENCH_ARENA_MARGIN 8U // Arena bytes kept back for the alignment of the nested command's arena
+
+//======================================================================[ INTERNAL DATA TYPES DEFINITIONS ]================================================================================ //
+
+/**
+ * @brief State of the "time" command, kept in its arena between calls.
+ */
+typedef struct
+{
+    CLI_Command_Context_t context; // Context of the command being timed
+    TickType_t startTick;          // Tick count when the command was entered
+    uint32_t returnTime;           // Time the last chunk was handed to the console
+    uint32_t transmitTime;         // Time the console spent transmitting the chunks so far
+    bool finished;                 // The command has completed, only the report is left
+} CliTime_s;
+
+/**
+ * @brief State of the "bench" command, kept in its arena between calls.
+ */
+typedef struct
+{
+    CLI_Command_Context_t context; // Context of the command being measured
+    uint32_t *largest;             // Largest run times, in decreasing order
+    uint32_t keep;                 // Number of run times kept in largest
+    uint32_t count;                // Number of runs requested
+    uint32_t runs;                 // Number of runs completed
+    uint32_t minTime;              // Shortest run time
+    uint64_t totalTime;            // Sum of the run times
+    TickType_t startTick;          // Tick count when the bench was entered
+} CliBench_s;
+
+//======================================================================[ INTERNAL FUNCTIONS AND OBJECTS DECLARATION ]===================================================================== //
+
+/**
+ * @brief Command callback function for the "time" command.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the command to time;
+ * \return     pdTRUE if more output follows, otherwise pdFALSE.
+ */
+static BaseType_t cliTimeCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
+
+/**
+ * @brief Command callback function for the "bench" command.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the number of runs and the command;
+ * \return     pdTRUE if more runs follow, otherwise pdFALSE.
+ */
+static BaseType_t cliBenchCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
+
+/**
+ * @brief Sets up a context nested in the current one, for the measured command.
+ *
+ * \param[out] context - Context to set up;
+ * \return     none.
+ */
+static void cliBenchInitContext(CLI_Command_Context_t *context);
+
+/**
+ * @brief Keeps a sample if it is among the largest ones seen so far.
+ *
+ * \param[in,out] largest - Largest samples, in decreasing order;
+ * \param[in]     keep    - Number of samples kept;
+ * \param[in]     count   - Number of samples seen before this one;
+ * \param[in]     sample  - New sample;
+ * \return        none.
+ */
+static void cliBenchKeepLargest(uint32_t *largest, uint32_t keep, uint32_t count, uint32_t sample);
+
+/**
+ * @brief Command definitions of the measurement commands.
+ */
+static const CLI_Command_Definition_t cliBenchDefinitions[] =
+    {
+        {
+            .pcCommand = "time",
+            .pcHelpString = "time <command> - runs a command and reports its lookup, parse, execute and transmit time \r\n",
+            .pxCommandInterpreter = cliTimeCommand,
+            .cExpectedNumberOfParameters = -1,
+            .usStackDepth = 384, // The measured command runs nested on the same stack
+        },
+        {
+            .pcCommand = "bench",
+            .pcHelpString = "bench <n> <command> - runs a command n times without output and reports min/avg/p99/max \r\n",
+            .pxCommandInterpreter = cliBenchCommand,
+            .cExpectedNumberOfParameters = -1,
+            .usStackDepth = 384, // The measured command runs nested on the same stack
+        }};
+
+//=======================================================================[PUBLIC INTERFACE FUNCTIONS]===================================================================================== //
+
+/**
+ * @brief Registers the "time" and "bench" commands with FreeRTOS CLI.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return int16_t - 0 on success, negative value on error.
+ */
+int16_t CliBenchCmdInit(void)
+{
+    int16_t status = 0;
+
+    for (size_t ind = 0; ind < (sizeof(cliBenchDefinitions) / sizeof(cliBenchDefinitions[0])); ind++)
+    {
+        if (FreeRTOS_CLIRegisterCommand(&cliBenchDefinitions[ind]) != pdPASS)
+        {
+            status = -1;
+        }
+    }
+
+    return status;
+}
+
+//=====================================================================[ PRIVATE FUNCTIONS ]============================================================================================== //
+
+/**
+ * @brief Command callback function for the "time" command.
+ *
+ * The output of the timed command is passed through chunk by chunk, then
+ * followed by a record with the time of each phase. The exit status is the
+ * timed command's.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the command to time;
+ * \return     pdTRUE if more output follows, otherwise pdFALSE.
+ */
+static BaseType_t cliTimeCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString)
+{
+    CLI_Command_Context_t *outerContext = FreeRTOS_CLIGetContext();
+    uint32_t now = configCOMMAND_INT_GET_TIME();
+    CliTime_s *state = (CliTime_s *)outerContext->pvCursor;
+    BaseType_t lineLength = 0;
+    const char *line = FreeRTOS_CLIGetParameter(pcCommandString, 1, &lineLength);
+    CLI_Record_t record;
+
+    if ((pcWriteBuffer == NULL) ||
+        (xWriteBufferLen == 0))
+    {
+        return pdFALSE;
+    }
+
+    if (line == NULL)
+    {
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_PARAMETER_COUNT, cliBenchDefinitions[0].pcHelpString);
+        FreeRTOS_CLISetStatus(cliSTATUS_BAD_PARAMETERS);
+        return pdFALSE;
+    }
+
+    if (state == NULL)
+    {
+        state = FreeRTOS_CLIArenaAlloc(sizeof(CliTime_s));
+        if (state == NULL)
+        {
+            FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_FULL, NULL);
+            FreeRTOS_CLISetStatus(cliSTATUS_FAILED);
+            return pdFALSE;
+        }
+
+        cliBenchInitContext(&state->context);
+        state->startTick = xTaskGetTickCount();
+        state->transmitTime = 0;
+        state->finished = false;
+        outerContext->pvCursor = state;
+    }
+    else
+    {
+        /* The console has transmitted the previous chunk since it was returned */
+        state->transmitTime += now - state->returnTime;
+    }
+
+    if (!state->finished)
+    {
+        FreeRTOS_CLISetContext(&state->context);
+        BaseType_t more = FreeRTOS_CLIProcessCommand(line, pcWriteBuffer, xWriteBufferLen);
+        FreeRTOS_CLISetContext(outerContext);
+
+        /* The chunk may be binary records */
+        outerContext->xOutputLength = state->context.xOutputLength;
+        state->finished = (more == pdFALSE);
+
+        if ((more != pdFALSE) ||
+            (FreeRTOS_CLIGetOutputLength(pcWriteBuffer) > 0))
+        {
+            state->returnTime = configCOMMAND_INT_GET_TIME();
+            return pdTRUE;
+        }
+    }
+
+    FreeRTOS_CLIRecordInit(&record, pcWriteBuffer, xWriteBufferLen);
+    FreeRTOS_CLIRecordBegin(&record);
+    FreeRTOS_CLIRecordString(&record, "command", line);
+    FreeRTOS_CLIRecordUnsigned(&record, "lookup", state->context.ulLookupTime);
+    FreeRTOS_CLIRecordUnsigned(&record, "parse", state->context.ulParseTime);
+    FreeRTOS_CLIRecordUnsigned(&record, "execute", state->context.ulExecuteTime);
+    FreeRTOS_CLIRecordUnsigned(&record, "transmit", state->transmitTime);
+    FreeRTOS_CLIRecordUnsigned(&record, "ticks", (uint32_t)(xTaskGetTickCount() - state->startTick));
+    (void)FreeRTOS_CLIRecordEnd(&record);
+
+    FreeRTOS_CLISetStatus(state->context.xStatus);
+
+    return pdFALSE;
+}
+
+/**
+ * @brief Command callback function for the "bench" command.
+ *
+ * Each run executes the command to completion, every chunk overwriting the
+ * previous one in pcWriteBuffer, and is timed from the lookup to the last
+ * call of the callback. A call makes at most CLI_BENCH_BATCH_RUNS runs, fewer
+ * if the time budget of "bench" runs out, and returns an empty chunk until
+ * the last run, so the bench never holds the worker for more than a batch.
+ * The bench stops at the first run that fails, leaving that run's output in
+ * the buffer.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the number of runs and the command;
+ * \return     pdTRUE if more runs follow, otherwise pdFALSE.
+ */
+static BaseType_t cliBenchCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString)
+{
+    CLI_Command_Context_t *outerContext = FreeRTOS_CLIGetContext();
+    CliBench_s *state = (CliBench_s *)outerContext->pvCursor;
+    BaseType_t runsLength = 0;
+    BaseType_t lineLength = 0;
+    const char *runsParam = FreeRTOS_CLIGetParameter(pcCommandString, 1, &runsLength);
+    const char *line = FreeRTOS_CLIGetParameter(pcCommandString, 2, &lineLength);
+    CLI_Record_t record;
+
+    if ((pcWriteBuffer == NULL) ||
+        (xWriteBufferLen == 0))
+    {
+        return pdFALSE;
+    }
+
+    if ((runsParam == NULL) ||
+        (line == NULL))
+    {
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_PARAMETER_COUNT, cliBenchDefinitions[1].pcHelpString);
+        FreeRTOS_CLISetStatus(cliSTATUS_BAD_PARAMETERS);
+        return pdFALSE;
+    }
+
+    if (state == NULL)
+    {
+        char *end = NULL;
+        unsigned long count = strtoul(runsParam, &end, 10);
+
+        if ((end != (runsParam + runsLength)) ||
+            (count == 0) ||
+            (count > CLI_BENCH_MAX_RUNS))
+        {
+            FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_INVALID_ARGUMENT, cliBenchDefinitions[1].pcHelpString);
+            FreeRTOS_CLISetStatus(cliSTATUS_FAILED);
+            return pdFALSE;
+        }
+
+        /* The 99th percentile is the run ranked ceil(0.99 * count), the smallest of the (keep) largest runs */
+        uint32_t keep = (uint32_t)count - (((uint32_t)count * 99U + 99U) / 100U) + 1U;
+
+        state = FreeRTOS_CLIArenaAlloc(sizeof(CliBench_s));
+        uint32_t *largest = (state != NULL) ? FreeRTOS_CLIArenaAlloc(keep * sizeof(uint32_t)) : NULL;
+
+        if (largest == NULL)
+        {
+            FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_FULL, NULL);
+            FreeRTOS_CLISetStatus(cliSTATUS_FAILED);
+            return pdFALSE;
+        }
+
+        cliBenchInitContext(&state->context);
+        state->largest = largest;
+        state->keep = keep;
+        state->count = (uint32_t)count;
+        state->runs = 0;
+        state->minTime = UINT32_MAX;
+        state->totalTime = 0;
+        state->startTick = xTaskGetTickCount();
+        outerContext->pvCursor = state;
+    }
+
+    for (uint32_t batch = 0; (batch < CLI_BENCH_BATCH_RUNS) && (state->runs < state->count); batch++)
+    {
+        FreeRTOS_CLISetContext(&state->context);
+        uint32_t start = configCOMMAND_INT_GET_TIME();
+        while (FreeRTOS_CLIProcessCommand(line, pcWriteBuffer, xWriteBufferLen) != pdFALSE)
+        {
+        }
+        uint32_t elapsed = configCOMMAND_INT_GET_TIME() - start;
+        BaseType_t runStatus = FreeRTOS_CLIGetStatus();
+        FreeRTOS_CLISetContext(outerContext);
+
+        if (runStatus != cliSTATUS_OK)
+        {
+            outerContext->xOutputLength = state->context.xOutputLength;
+            FreeRTOS_CLISetStatus(runStatus);
+            return pdFALSE;
+        }
+
+        cliBenchKeepLargest(state->largest, state->keep, state->runs, elapsed);
+        state->minTime = (elapsed < state->minTime) ? elapsed : state->minTime;
+        state->totalTime += elapsed;
+        state->runs++;
+
+        /* Hand the worker back once the call has used up its budget */
+        if (FreeRTOS_CLIYieldCheck() != pdFALSE)
+        {
+            break;
+        }
+    }
+
+    if (state->runs < state->count)
+    {
+        /* The output of the runs is discarded, the next call continues the bench */
+        pcWriteBuffer[0] = '\0';
+        outerContext->xOutputLength = 0U;
+        return pdTRUE;
+    }
+
+    FreeRTOS_CLIRecordInit(&record, pcWriteBuffer, xWriteBufferLen);
+    FreeRTOS_CLIRecordBegin(&record);
+    FreeRTOS_CLIRecordString(&record, "command", line);
+    FreeRTOS_CLIRecordUnsigned(&record, "runs", state->runs);
+    FreeRTOS_CLIRecordUnsigned(&record, "min", state->minTime);
+    FreeRTOS_CLIRecordUnsigned(&record, "avg", (uint32_t)(state->totalTime / state->runs));
+    FreeRTOS_CLIRecordUnsigned(&record, "p99", state->largest[state->keep - 1U]);
+    FreeRTOS_CLIRecordUnsigned(&record, "max", state->largest[0]);
+    FreeRTOS_CLIRecordUnsigned(&record, "ticks", (uint32_t)(xTaskGetTickCount() - state->startTick));
+    (void)FreeRTOS_CLIRecordEnd(&record);
+
+    return pdFALSE;
+}
+
+/**
+ * @brief Sets up a context nested in the current one, for the measured command.
+ *
+ * The measured command gets the rest of the current command's arena and the
+ * session's verbosity and format.
+ *
+ * \param[out] context - Context to set up;
+ * \return     none.
+ */
+static void cliBenchInitContext(CLI_Command_Context_t *context)
+{
+    CLI_Command_Context_t *outerContext = FreeRTOS_CLIGetContext();
+    size_t arenaSize = (outerContext->pucArena != NULL) ? (outerContext->xArenaSize - outerContext->xArenaUsed) : 0;
+    void *arena = (arenaSize > CLI_BENCH_ARENA_MARGIN) ? FreeRTOS_CLIArenaAlloc(arenaSize - CLI_BENCH_ARENA_MARGIN) : NULL;
+
+    FreeRTOS_CLIInitContext(context, arena, (arena != NULL) ? (arenaSize - CLI_BENCH_ARENA_MARGIN) : 0U);
+    context->ucVerbosity = outerContext->ucVerbosity;
+    context->ucFormat = outerContext->ucFormat;
+    context->ucNesting = outerContext->ucNesting;
+}
+
+/**
+ * @brief Keeps a sample if it is among the largest ones seen so far.
+ *
+ * \param[in,out] largest - Largest samples, in decreasing order;
+ * \param[in]     keep    - Number of samples kept;
+ * \param[in]     count   - Number of samples seen before this one;
+ * \param[in]     sample  - New sample;
+ * \return        none.
+ */
+static void cliBenchKeepLargest(uint32_t *largest, uint32_t keep, uint32_t count, uint32_t sample)
+{
+    uint32_t ind = (count < keep) ? count : keep;
+
+    if ((ind == keep) &&
+        (sample <= largest[keep - 1U]))
+    {
+        return;
+    }
+
+    /* Shift the smaller samples down, dropping the smallest once full */
+    if (ind == keep)
+    {
+        ind--;
+    }
+
+    while ((ind > 0) &&
+           (largest[ind - 1U] < sample))
+    {
+        largest[ind] = largest[ind - 1U];
+        ind--;
+    }
+
+    largest[ind] = sample;
+}
+
+#endif /* configCOMMAND_INT_USE_STATS */
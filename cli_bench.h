@@ -0,0 +1,50 @@
+/**
+ * @file cli_bench.h
+ * @brief Measurement of the cost of commands on the target.
+ *
+ * @details
+ * This file declares the "time" and "bench" commands. "time <command>" runs a
+ * command once, passing its output through, and then reports where the time
+ * went: finding the command, checking its parameters, running its callback and
+ * transmitting its output. "bench <n> <command>" runs a command n times with
+ * its output discarded and reports the minimum, average, 99th percentile and
+ * maximum run time. A bench runs in batches of at most CLI_BENCH_BATCH_RUNS,
+ * one per call of its callback, so it keeps to the per-call time budget.
+ *
+ * Times are taken at the same points as the statistics of the "stats" command,
+ * in configCOMMAND_INT_GET_TIME() units, which may be ticks or cycles
+ * depending on FreeRTOSConfig.h. The elapsed ticks are reported as well.
+ *
+ * @date Created on 17.10.2026
+ * @author Yauheni Bialkou
+ */
+
+#ifndef CLI_BENCH_H
+#define CLI_BENCH_H
+
+//================================================================[INCLUDE]================================================================================================================//
+
+#include "FreeRTOS.h"     // FreeRTOS kernel headers
+#include "FreeRTOS_CLI.h" // FreeRTOS CLI API
+
+//===========================================================[MACRO DEFINITIONS]===========================================================================================================//
+
+#define CLI_BENCH_MAX_RUNS 10000 // Largest number of runs of "bench"
+#define CLI_BENCH_BATCH_RUNS 16  // Largest number of runs of "bench" in one call of its callback
+
+//===========================================================[PUBLIC INTERFACE]============================================================================================================//
+
+#if (configCOMMAND_INT_USE_STATS == 1)
+
+/**
+ * @brief Registers the "time" and "bench" commands with FreeRTOS CLI.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return int16_t - 0 on success, negative value on error.
+ */
+int16_t CliBenchCmdInit(void);
+
+#endif /* configCOMMAND_INT_USE_STATS */
+
+#endif /* CLI_BENCH_H */
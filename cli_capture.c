@@ -0,0 +1,385 @@
+/**
+ * @file cli_capture.c
+ * @brief Implementation of the capture of the console traffic.
+ *
+ * @details
+ * Entries are written from the UART RX interrupt and from the task that
+ * transmits the output, so the ring is only touched with interrupts masked.
+ * Fixed-size entries keep that section short: the oldest entry is overwritten
+ * by moving an index, without decoding anything.
+ *
+ * @date Created on 17.10.2026
+ * @author Yauheni Bialkou
+ */
+
+//======================================================================[ INCLUDE ]======================================================================================================== //
+
+#include "cli_capture.h"
+#include <stdio.h>
+#include <string.h>
+
+#if (CLI_CAPTURE_ENTRIES > 0)
+
+//======================================================================[ INTERNAL MACRO DEFENITIONS ]===================================================================================== //
+
+#define CLI_CAPTURE_KIND_SHIFT (CLI_CAPTURE_TIME_BITS + CLI_CAPTURE_DATA_BITS) // Position of the kind in an entry
+#define CLI_CAPTURE_TIME_MAX ((1UL << CLI_CAPTURE_TIME_BITS) - 1UL)            // Longest time of an entry
+#define CLI_CAPTURE_GAP_MAX ((1UL << CLI_CAPTURE_KIND_SHIFT) - 1UL)            // Longest time of a gap entry, longer gaps are clamped
+#define CLI_CAPTURE_DATA_MAX ((1UL << CLI_CAPTURE_DATA_BITS) - 1UL)            // Largest data of an entry, longer chunks are clamped
+#define CLI_CAPTURE_DUMP_WORDS 8                                               // Entries written per record by "capture dump"
+
+//======================================================================[ INTERNAL DATA TYPES DEFINITIONS ]================================================================================ //
+
+/**
+ * @brief Structure holding the capture ring.
+ */
+typedef struct
+{
+    uint32_t entries[CLI_CAPTURE_ENTRIES]; // Ring of entries
+    uint16_t head;                         // Index of the next entry written
+    uint16_t count;                        // Number of valid entries, up to CLI_CAPTURE_ENTRIES
+    uint32_t overwritten;                  // Number of entries lost to the ring wrapping since the last clear
+    uint32_t lastTime;                     // Time of the last entry
+    volatile bool running;                 // Entries are being logged
+} CliCapture_s;
+
+//======================================================================[ INTERNAL FUNCTIONS AND OBJECTS DECLARATION ]===================================================================== //
+
+static CliCapture_s cliCapture = {0}; // Capture ring
+
+/**
+ * @brief Command callback function for the "capture" command.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the subcommand;
+ * \return     pdTRUE if more output follows, otherwise pdFALSE.
+ */
+static BaseType_t cliCaptureCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
+
+/**
+ * @brief Writes the capture ring as records, as many as fit per call.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \return     pdTRUE if more output follows, otherwise pdFALSE.
+ */
+static BaseType_t cliCaptureDump(char *pcWriteBuffer, size_t xWriteBufferLen);
+
+/**
+ * @brief Logs one entry, with the time elapsed since the previous one.
+ *
+ * \param[in]  kind - Kind of the entry;
+ * \param[in]  data - Data of the entry;
+ * \return     none.
+ */
+static void cliCaptureLog(CliCaptureKind_e kind, uint32_t data);
+
+/**
+ * @brief Appends an entry to the ring, overwriting the oldest one when full.
+ *
+ * \param[in]  entry - Entry to append;
+ * \return     none.
+ */
+static void cliCapturePut(uint32_t entry);
+
+/**
+ * @brief Command definitions of the capture commands.
+ */
+static const CLI_Command_Definition_t cliCaptureDefinitions[] =
+    {
+        {
+            .pcCommand = "capture",
+            .pcHelpString = "capture start | stop | clear | dump - logs the console traffic with its timing \r\n",
+            .pxCommandInterpreter = cliCaptureCommand,
+            .cExpectedNumberOfParameters = 1,
+        }};
+
+//=======================================================================[PUBLIC INTERFACE FUNCTIONS]===================================================================================== //
+
+/**
+ * @brief Starts or stops the capture.
+ *
+ * \param[in]  run - If true, the capture starts; otherwise, it stops;
+ * \param[out] none;
+ * \return none.
+ */
+void CliCaptureRun(bool run)
+{
+    taskENTER_CRITICAL();
+
+    /* The first entry after a start is timed from the start */
+    if (run && !cliCapture.running)
+    {
+        cliCapture.lastTime = (uint32_t)CLI_CAPTURE_TIME();
+    }
+    cliCapture.running = run;
+
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Discards all the entries of the capture ring.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return none.
+ */
+void CliCaptureClear(void)
+{
+    taskENTER_CRITICAL();
+
+    cliCapture.head = 0;
+    cliCapture.count = 0;
+    cliCapture.overwritten = 0;
+    cliCapture.lastTime = (uint32_t)CLI_CAPTURE_TIME();
+
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Logs a character received by the console.
+ *
+ * \param[in]  rxChar - Received character;
+ * \param[out] none;
+ * \return none.
+ */
+void CliCaptureRx(char rxChar)
+{
+    if (cliCapture.running)
+    {
+        cliCaptureLog(CLI_CAPTURE_RX, (uint8_t)rxChar);
+    }
+}
+
+/**
+ * @brief Logs a chunk of output about to be transmitted by the console.
+ *
+ * \param[in]  length - Length of the chunk, in bytes;
+ * \param[out] none;
+ * \return none.
+ */
+void CliCaptureTx(uint16_t length)
+{
+    if (cliCapture.running)
+    {
+        cliCaptureLog(CLI_CAPTURE_TX, (length > CLI_CAPTURE_DATA_MAX) ? CLI_CAPTURE_DATA_MAX : length);
+    }
+}
+
+/**
+ * @brief Copies entries of the capture ring, oldest first.
+ *
+ * \param[in]  first   - Index of the first entry to copy, 0 being the oldest;
+ * \param[out] entries - Buffer receiving the entries;
+ * \param[in]  count   - Maximum number of entries to copy;
+ * \return uint16_t - Number of entries copied.
+ */
+uint16_t CliCaptureRead(uint16_t first, uint32_t *entries, uint16_t count)
+{
+    uint16_t copied = 0;
+
+    taskENTER_CRITICAL();
+
+    uint16_t oldest = (uint16_t)((cliCapture.head + CLI_CAPTURE_ENTRIES - cliCapture.count) % CLI_CAPTURE_ENTRIES);
+
+    while ((copied < count) &&
+           ((first + copied) < cliCapture.count))
+    {
+        entries[copied] = cliCapture.entries[(oldest + first + copied) % CLI_CAPTURE_ENTRIES];
+        copied++;
+    }
+
+    taskEXIT_CRITICAL();
+
+    return copied;
+}
+
+/**
+ * @brief Registers the "capture" command with FreeRTOS CLI.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return int16_t - 0 on success, negative value on error.
+ */
+int16_t CliCaptureCmdInit(void)
+{
+    int16_t status = 0;
+
+    for (size_t ind = 0; ind < (sizeof(cliCaptureDefinitions) / sizeof(cliCaptureDefinitions[0])); ind++)
+    {
+        if (FreeRTOS_CLIRegisterCommand(&cliCaptureDefinitions[ind]) != pdPASS)
+        {
+            status = -1;
+        }
+    }
+
+    return status;
+}
+
+//=====================================================================[ PRIVATE FUNCTIONS ]============================================================================================== //
+
+/**
+ * @brief Command callback function for the "capture" command.
+ *
+ * "capture dump" stops the capture first, otherwise the dump's own output
+ * would be logged and shift the entries being listed.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the subcommand;
+ * \return     pdTRUE if more output follows, otherwise pdFALSE.
+ */
+static BaseType_t cliCaptureCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString)
+{
+    BaseType_t subLength = 0;
+    const char *sub = FreeRTOS_CLIGetParameter(pcCommandString, 1, &subLength);
+
+    if ((pcWriteBuffer == NULL) ||
+        (xWriteBufferLen == 0))
+    {
+        return pdFALSE;
+    }
+
+    if ((subLength == 4) && (strncmp(sub, "dump", 4) == 0))
+    {
+        CliCaptureRun(false);
+        return cliCaptureDump(pcWriteBuffer, xWriteBufferLen);
+    }
+
+    if ((subLength == 5) && (strncmp(sub, "start", 5) == 0))
+    {
+        CliCaptureRun(true);
+    }
+    else if ((subLength == 4) && (strncmp(sub, "stop", 4) == 0))
+    {
+        CliCaptureRun(false);
+    }
+    else if ((subLength == 5) && (strncmp(sub, "clear", 5) == 0))
+    {
+        CliCaptureClear();
+    }
+    else
+    {
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_INVALID_ARGUMENT, cliCaptureDefinitions[0].pcHelpString);
+        FreeRTOS_CLISetStatus(cliSTATUS_FAILED);
+        return pdFALSE;
+    }
+
+    snprintf(pcWriteBuffer, xWriteBufferLen, "OK\r\n");
+
+    return pdFALSE;
+}
+
+/**
+ * @brief Writes the capture ring as records, as many as fit per call.
+ *
+ * The first record gives the number of entries, the number lost to the ring
+ * wrapping and the time unit. Each following record holds the index of its
+ * first entry and up to CLI_CAPTURE_DUMP_WORDS entries as hexadecimal words.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \return     pdTRUE if more output follows, otherwise pdFALSE.
+ */
+static BaseType_t cliCaptureDump(char *pcWriteBuffer, size_t xWriteBufferLen)
+{
+    CLI_Command_Context_t *context = FreeRTOS_CLIGetContext();
+    uint32_t entries[CLI_CAPTURE_DUMP_WORDS] = {0};
+    char words[(CLI_CAPTURE_DUMP_WORDS * 8) + 1] = {0};
+    CLI_Record_t record;
+
+    FreeRTOS_CLIRecordInit(&record, pcWriteBuffer, xWriteBufferLen);
+
+    /* pvCursor is set once the header has been written */
+    if (context->pvCursor == NULL)
+    {
+        FreeRTOS_CLIRecordBegin(&record);
+        FreeRTOS_CLIRecordString(&record, "capture", CLI_CAPTURE_TIME_UNIT);
+        FreeRTOS_CLIRecordUnsigned(&record, "entries", cliCapture.count);
+        FreeRTOS_CLIRecordUnsigned(&record, "overwritten", cliCapture.overwritten);
+        (void)FreeRTOS_CLIRecordEnd(&record);
+
+        context->pvCursor = &cliCapture;
+    }
+
+    while (1)
+    {
+        uint16_t count = CliCaptureRead((uint16_t)context->uxIndex, entries, CLI_CAPTURE_DUMP_WORDS);
+
+        if (count == 0)
+        {
+            return pdFALSE;
+        }
+
+        for (uint16_t ind = 0; ind < count; ind++)
+        {
+            snprintf(&words[ind * 8U], sizeof(words) - (ind * 8U), "%08lx", (unsigned long)entries[ind]);
+        }
+
+        FreeRTOS_CLIRecordBegin(&record);
+        FreeRTOS_CLIRecordUnsigned(&record, "index", context->uxIndex);
+        FreeRTOS_CLIRecordString(&record, "data", words);
+
+        if ((FreeRTOS_CLIRecordEnd(&record) != pdPASS) &&
+            (FreeRTOS_CLIRecordLength(&record) != 0))
+        {
+            /* The record does not fit, send it with the next chunk */
+            return pdTRUE;
+        }
+
+        context->uxIndex += count;
+    }
+}
+
+/**
+ * @brief Logs one entry, with the time elapsed since the previous one.
+ *
+ * \param[in]  kind - Kind of the entry;
+ * \param[in]  data - Data of the entry;
+ * \return     none.
+ */
+static void cliCaptureLog(CliCaptureKind_e kind, uint32_t data)
+{
+    UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+    uint32_t now = (uint32_t)CLI_CAPTURE_TIME();
+    uint32_t elapsed = now - cliCapture.lastTime;
+
+    cliCapture.lastTime = now;
+
+    if (elapsed > CLI_CAPTURE_TIME_MAX)
+    {
+        cliCapturePut(((uint32_t)CLI_CAPTURE_GAP << CLI_CAPTURE_KIND_SHIFT) |
+                      ((elapsed > CLI_CAPTURE_GAP_MAX) ? CLI_CAPTURE_GAP_MAX : elapsed));
+        elapsed = 0;
+    }
+
+    cliCapturePut(((uint32_t)kind << CLI_CAPTURE_KIND_SHIFT) |
+                  (elapsed << CLI_CAPTURE_DATA_BITS) |
+                  data);
+
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+}
+
+/**
+ * @brief Appends an entry to the ring, overwriting the oldest one when full.
+ *
+ * \param[in]  entry - Entry to append;
+ * \return     none.
+ */
+static void cliCapturePut(uint32_t entry)
+{
+    cliCapture.entries[cliCapture.head] = entry;
+    cliCapture.head = (uint16_t)((cliCapture.head + 1U) % CLI_CAPTURE_ENTRIES);
+
+    if (cliCapture.count < CLI_CAPTURE_ENTRIES)
+    {
+        cliCapture.count++;
+    }
+    else
+    {
+        cliCapture.overwritten++;
+    }
+}
+
+#endif /* CLI_CAPTURE_ENTRIES */
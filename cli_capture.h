@@ -0,0 +1,133 @@
+/**
+ * @file cli_capture.h
+ * @brief Capture of the console traffic for reproducing field sessions.
+ *
+ * @details
+ * While a capture runs, every character received by the console and every
+ * chunk of output it transmits is logged with its time into a ring in RAM.
+ * Once full, the ring overwrites its oldest entries, so it always holds the
+ * most recent traffic. The log is read out with "capture dump", and feeding
+ * its RX entries back with their original spacing reproduces the session.
+ *
+ * Each entry is one 32-bit word:
+ *
+ *   bits 31-30  kind, a CliCaptureKind_e value;
+ *   bits 29-10  time since the previous entry;
+ *   bits  9-0   the received character, or the length of the output chunk.
+ *
+ * A gap too long for 20 bits is logged as a CLI_CAPTURE_GAP entry whose bits
+ * 29-0 hold the whole time, followed by the entry itself with a time of 0.
+ * Times are in CLI_CAPTURE_TIME_UNIT.
+ *
+ * The default time source is the tick, which cannot resolve the timing of
+ * single characters: at 115200 baud a character takes about 87 us, so with a
+ * 1 ms tick about eleven characters share one tick and most RX entries carry
+ * a time of 0. Such a capture keeps the order of the traffic and the pauses
+ * between bursts, such as typing gaps or a host's pacing, but replaying it
+ * cannot reproduce the spacing of the characters within a burst. For that,
+ * map CLI_CAPTURE_TIME() onto a free-running microsecond counter, such as the
+ * one behind CLI_GET_TIME_US() in cli.h, and set CLI_CAPTURE_TIME_UNIT to
+ * "us"; the 20-bit time of an entry then spans about one second.
+ *
+ * @date Created on 17.10.2026
+ * @author Yauheni Bialkou
+ */
+
+#ifndef CLI_CAPTURE_H
+#define CLI_CAPTURE_H
+
+//================================================================[INCLUDE]================================================================================================================//
+
+#include "FreeRTOS.h"     // FreeRTOS kernel headers
+#include "task.h"         // Tick count used as the default time source
+#include "FreeRTOS_CLI.h" // FreeRTOS CLI API
+#include <stdbool.h>
+
+//===========================================================[MACRO DEFINITIONS]===========================================================================================================//
+
+#define CLI_CAPTURE_ENTRIES 256                         // Number of entries of the capture ring, 4 bytes each, 0 to disable capture
+#define CLI_CAPTURE_TIME() xTaskGetTickCountFromISR()   // Time source of the capture, callable from the UART interrupt; too coarse for per-character timing, see above (depends on your project setup)
+#define CLI_CAPTURE_TIME_UNIT "tick"                    // Unit of CLI_CAPTURE_TIME(), reported by "capture dump"
+
+#define CLI_CAPTURE_TIME_BITS 20                        // Width of the time of an entry
+#define CLI_CAPTURE_DATA_BITS 10                        // Width of the data of an entry
+
+//========================================================[DATA TYPES DEFINITIONS]=========================================================================================================//
+
+/**
+ * @brief Enumeration for the kinds of capture entries.
+ */
+typedef enum
+{
+    CLI_CAPTURE_GAP = 0, // Time elapsed before the next entry
+    CLI_CAPTURE_RX = 1,  // A character received by the console
+    CLI_CAPTURE_TX = 2   // A chunk of output transmitted by the console
+
+} CliCaptureKind_e;
+
+//===========================================================[PUBLIC INTERFACE]============================================================================================================//
+
+#if (CLI_CAPTURE_ENTRIES > 0)
+
+/**
+ * @brief Starts or stops the capture.
+ *
+ * Stopping keeps the entries logged so far; starting again appends to them.
+ *
+ * \param[in]  run - If true, the capture starts; otherwise, it stops;
+ * \param[out] none;
+ * \return none.
+ */
+void CliCaptureRun(bool run);
+
+/**
+ * @brief Discards all the entries of the capture ring.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return none.
+ */
+void CliCaptureClear(void);
+
+/**
+ * @brief Logs a character received by the console.
+ *
+ * Called from the UART RX interrupt, with the character as it arrived.
+ *
+ * \param[in]  rxChar - Received character;
+ * \param[out] none;
+ * \return none.
+ */
+void CliCaptureRx(char rxChar);
+
+/**
+ * @brief Logs a chunk of output about to be transmitted by the console.
+ *
+ * \param[in]  length - Length of the chunk, in bytes;
+ * \param[out] none;
+ * \return none.
+ */
+void CliCaptureTx(uint16_t length);
+
+/**
+ * @brief Copies entries of the capture ring, oldest first.
+ *
+ * \param[in]  first   - Index of the first entry to copy, 0 being the oldest;
+ * \param[out] entries - Buffer receiving the entries;
+ * \param[in]  count   - Maximum number of entries to copy;
+ * \return uint16_t - Number of entries copied.
+ */
+uint16_t CliCaptureRead(uint16_t first, uint32_t *entries, uint16_t count);
+
+/**
+ * @brief Registers the "capture" command with FreeRTOS CLI.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return int16_t - 0 on success, negative value on error.
+ */
+int16_t CliCaptureCmdInit(void);
+
+#endif /* CLI_CAPTURE_ENTRIES */
+
+#endif /* CLI_CAPTURE_H */
@@ -12,16 +12,42 @@
 //=====================================================================[ INCLUDE ]=========================================================================================================//
 
 #include "cli_cmd.h"
+#include "cli_config.h"
+#include "cli_script.h"
+#include "cli_capture.h"
+#include "cli_bench.h"
+#include "cli_alias.h"
+#include "cli_loop.h"
+#include "cli_job.h"
+#include <stdbool.h>
 
 //=====================================================================[ INTERNAL MACRO DEFENITIONS ]======================================================================================//
 
-#define CLI_COMMAND_COUNT (sizeof(CliCommands) / sizeof(CliCommands[0])) // Calculate the number of commands
+#define CLI_COMMAND_COUNT (sizeof(CliCommands) / sizeof(CliCommands[0]))         // Calculate the number of commands
+#define CLI_GROUP_COUNT (sizeof(CliCommandGroups) / sizeof(CliCommandGroups[0])) // Calculate the number of command groups
+
+//=====================================================================[ INTERNAL DATA TYPES DEFINITIONS ]=================================================================================//
+
+/**
+ * @brief Structure representing a command group loaded on first use.
+ */
+typedef struct
+{
+    CLI_Command_Definition_t stub; // Stub registered in place of the group's commands
+    int16_t (*init)(void);         // Registers the group's commands and initialises what they need, 0 on success
+    const char *unavailable;       // Error message written if the group cannot be loaded
+    bool loaded;                   // The group's commands have been registered
+
+} CliCommandGroup_s;
 
 //=====================================================================[ INTERNAL FUNCTIONS AND OBJECTS DECLARATION ]======================================================================//
 
 static char hello[] = "Hello world \r\n";         // Message to be printed for the "hello" command
 static char version[] = "CLI Version 1.0.0 \r\n"; // Message to be printed for the "version" command
 
+static const char modeHelp[] = "mode <human|terse> - selects full or coded error messages for this session \r\n";                // Help of the "mode" command, also its usage error
+static const char formatHelp[] = "format <text|json|cbor> - selects how command results are written for this session \r\n"; // Help of the "format" command, also its usage error
+
 /**
  * @brief Command callback function for the "hello" command.
  *
@@ -42,6 +68,36 @@ static BaseType_t cliCallbackHelloCommand(char *pcWriteBuffer, size_t xWriteBuff
  */
 static BaseType_t cliCallbackVersionCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
 
+/**
+ * @brief Command callback function for the "mode" command.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the mode name;
+ * \return     pdFALSE (indicates that the output has been fully written).
+ */
+static BaseType_t cliCallbackModeCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
+
+/**
+ * @brief Command callback function for the "format" command.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the format name;
+ * \return     pdFALSE (indicates that the output has been fully written).
+ */
+static BaseType_t cliCallbackFormatCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
+
+/**
+ * @brief Loader of the command groups, called through the stub of the group to load.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where an error message is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string that triggered the loading;
+ * \return     pdPASS if the group was loaded, otherwise pdFAIL.
+ */
+static BaseType_t cliLoadGroup(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
+
 /**
  * @brief Array of CLI commands.
  *
@@ -60,8 +116,115 @@ static CLI_Command_Definition_t CliCommands[] =
             .pcHelpString = "version - prints CLI version \r\n",
             .pxCommandInterpreter = cliCallbackVersionCommand,
             .cExpectedNumberOfParameters = 0,
+        },
+        {
+            .pcCommand = "mode",
+            .pcHelpString = modeHelp,
+            .pxCommandInterpreter = cliCallbackModeCommand,
+            .cExpectedNumberOfParameters = 1,
+        },
+        {
+            .pcCommand = "format",
+            .pcHelpString = formatHelp,
+            .pxCommandInterpreter = cliCallbackFormatCommand,
+            .cExpectedNumberOfParameters = 1,
         }};
 
+/**
+ * @brief Array of CLI command groups.
+ *
+ * Each group is registered as a single stub at startup. Its commands are only
+ * registered, and its resources initialised, when one of them is first used,
+ * which keeps that work out of the time to the first prompt. Every stub runs
+ * cliLoadGroup(), which finds the group by its stub.
+ */
+static CliCommandGroup_s CliCommandGroups[] =
+    {
+        {
+            .stub =
+                {
+                    .pcCommand = "config",
+                    .pcHelpString = "config - device configuration (get, set, list, commit, stats) \r\n",
+                    .pxCommandInterpreter = cliLoadGroup,
+                    .cExpectedNumberOfParameters = -1,
+                    .ucFlags = cliCOMMAND_FLAG_GROUP,
+                },
+            .init = CliConfigCmdInit,
+            .unavailable = "Configuration store unavailable \r\n",
+        },
+        {
+            .stub =
+                {
+                    .pcCommand = "script exec",
+                    .pcHelpString = "script, exec - stored command scripts \r\n",
+                    .pxCommandInterpreter = cliLoadGroup,
+                    .cExpectedNumberOfParameters = -1,
+                    .ucFlags = cliCOMMAND_FLAG_GROUP,
+                    .usStackDepth = 384,
+                },
+            .init = CliScriptCmdInit,
+            .unavailable = "Script commands unavailable \r\n",
+        },
+#if (CLI_CAPTURE_ENTRIES > 0)
+        {
+            .stub =
+                {
+                    .pcCommand = "capture",
+                    .pcHelpString = "capture - logs the console traffic with its timing (start, stop, clear, dump) \r\n",
+                    .pxCommandInterpreter = cliLoadGroup,
+                    .cExpectedNumberOfParameters = -1,
+                    .ucFlags = cliCOMMAND_FLAG_GROUP,
+                },
+            .init = CliCaptureCmdInit,
+            .unavailable = "Capture commands unavailable \r\n",
+        },
+#endif
+#if (configCOMMAND_INT_USE_STATS == 1)
+        {
+            .stub =
+                {
+                    .pcCommand = "time bench",
+                    .pcHelpString = "time, bench - measure the cost of a command on this device \r\n",
+                    .pxCommandInterpreter = cliLoadGroup,
+                    .cExpectedNumberOfParameters = -1,
+                    .ucFlags = cliCOMMAND_FLAG_GROUP,
+                    .usStackDepth = 384,
+                },
+            .init = CliBenchCmdInit,
+            .unavailable = "Measurement commands unavailable \r\n",
+        },
+#endif
+#if (CLI_LOOP_MAX_RUNS > 0)
+        {
+            .stub =
+                {
+                    .pcCommand = "repeat for",
+                    .pcHelpString = "repeat, for - run a command several times on this device \r\n",
+                    .pxCommandInterpreter = cliLoadGroup,
+                    .cExpectedNumberOfParameters = -1,
+                    .ucFlags = cliCOMMAND_FLAG_GROUP,
+                    .usStackDepth = 384,
+                },
+            .init = CliLoopCmdInit,
+            .unavailable = "Loop commands unavailable \r\n",
+        },
+#endif
+#if (CLI_JOB_COUNT > 0)
+        {
+            .stub =
+                {
+                    .pcCommand = "at every jobs",
+                    .pcHelpString = "at, every, jobs - run commands later or periodically on this device \r\n",
+                    .pxCommandInterpreter = cliLoadGroup,
+                    .cExpectedNumberOfParameters = -1,
+                    .ucFlags = cliCOMMAND_FLAG_GROUP,
+                },
+            .init = CliJobCmdInit,
+            .unavailable = "Job commands unavailable \r\n",
+        },
+#endif
+};
+
 //=======================================================================[PUBLIC INTERFACE FUNCTIONS]======================================================================================//
 
 /**
@@ -73,16 +236,77 @@ static CLI_Command_Definition_t CliCommands[] =
  */
 int16_t CliCmdInit(void)
 {
+    int16_t status = 0;
+
     /* Loop through all commands */
     for (size_t ind = 0; ind < CLI_COMMAND_COUNT; ind++)
     {
         FreeRTOS_CLIRegisterCommand(&CliCommands[ind]);
     }
-    return 0;
+
+    /* Register one stub per command group, the groups load on first use */
+    for (size_t ind = 0; ind < CLI_GROUP_COUNT; ind++)
+    {
+        if (FreeRTOS_CLIRegisterCommand(&CliCommandGroups[ind].stub) != pdPASS)
+        {
+            status = -1;
+        }
+    }
+
+#if (CLI_ALIAS_COUNT > 0)
+    /* Not a group: committed aliases must answer from the first command on */
+    if (CliAliasCmdInit() != 0)
+    {
+        status = -1;
+    }
+#endif
+
+    return status;
 }
 
 //=====================================================================[ PRIVATE FUNCTIONS ]===============================================================================================//
 
+/**
+ * @brief Loader of the command groups, called through the stub of the group to load.
+ *
+ * The interpreter still resolves the command string to the stub while the
+ * group loads, which tells the group apart.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where an error message is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string that triggered the loading;
+ * \return     pdPASS if the group was loaded, otherwise pdFAIL.
+ */
+static BaseType_t cliLoadGroup(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString)
+{
+    CLI_Definition_List_Item_t *stub = FreeRTOS_CLIFindCommand(pcCommandString);
+
+    for (size_t ind = 0; ind < CLI_GROUP_COUNT; ind++)
+    {
+        CliCommandGroup_s *group = &CliCommandGroups[ind];
+
+        if ((stub == NULL) ||
+            (stub->pxCommandLineDefinition != &group->stub))
+        {
+            continue;
+        }
+
+        /* A group whose commands are registered must not register them twice */
+        if ((!group->loaded) &&
+            (group->init() != 0))
+        {
+            FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_UNAVAILABLE, group->unavailable);
+            return pdFAIL;
+        }
+
+        group->loaded = true;
+        return pdPASS;
+    }
+
+    FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_UNAVAILABLE, NULL);
+    return pdFAIL;
+}
+
 /**
  * @brief Command callback function for the "hello" command.
  *
@@ -132,3 +356,90 @@ static BaseType_t cliCallbackVersionCommand(char *pcWriteBuffer, size_t xWriteBu
     strcpy(pcWriteBuffer, version);
     return pdFALSE;
 }
+
+/**
+ * @brief Command callback function for the "mode" command.
+ *
+ * The verbosity is kept in the session's command context, so it applies to
+ * every following command of the session until it is changed or the session
+ * is logged out.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the mode name;
+ * \return     pdFALSE (indicates that the output has been fully written).
+ */
+static BaseType_t cliCallbackModeCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString)
+{
+    BaseType_t length = 0;
+    const char *mode = FreeRTOS_CLIGetParameter(pcCommandString, 1, &length);
+
+    if ((pcWriteBuffer == NULL) ||
+        (xWriteBufferLen == 0))
+    {
+        return pdFALSE;
+    }
+
+    if ((length == 5) && (strncmp(mode, "human", 5) == 0))
+    {
+        FreeRTOS_CLISetVerbosity(cliVERBOSITY_HUMAN);
+        snprintf(pcWriteBuffer, xWriteBufferLen, "Human readable messages \r\n");
+    }
+    else if ((length == 5) && (strncmp(mode, "terse", 5) == 0))
+    {
+        FreeRTOS_CLISetVerbosity(cliVERBOSITY_TERSE);
+        snprintf(pcWriteBuffer, xWriteBufferLen, "OK\r\n");
+    }
+    else
+    {
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_INVALID_ARGUMENT, modeHelp);
+        FreeRTOS_CLISetStatus(cliSTATUS_FAILED);
+    }
+
+    return pdFALSE;
+}
+
+/**
+ * @brief Command callback function for the "format" command.
+ *
+ * Like the verbosity, the format is kept in the session's command context.
+ * Commands that write their results as records render them in this format;
+ * the confirmation is written in the new format too.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the format name;
+ * \return     pdFALSE (indicates that the output has been fully written).
+ */
+static BaseType_t cliCallbackFormatCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString)
+{
+    static const char *const formats[] = {"text", "json", "cbor"}; // Indexed by cliFORMAT_xxx
+    BaseType_t length = 0;
+    const char *format = FreeRTOS_CLIGetParameter(pcCommandString, 1, &length);
+    CLI_Record_t record;
+
+    if ((pcWriteBuffer == NULL) ||
+        (xWriteBufferLen == 0))
+    {
+        return pdFALSE;
+    }
+
+    for (uint8_t ind = 0; ind < (sizeof(formats) / sizeof(formats[0])); ind++)
+    {
+        if ((length == 4) && (strncmp(format, formats[ind], 4) == 0))
+        {
+            FreeRTOS_CLISetFormat(ind);
+
+            FreeRTOS_CLIRecordInit(&record, pcWriteBuffer, xWriteBufferLen);
+            FreeRTOS_CLIRecordBegin(&record);
+            FreeRTOS_CLIRecordString(&record, "format", formats[ind]);
+            (void)FreeRTOS_CLIRecordEnd(&record);
+            return pdFALSE;
+        }
+    }
+
+    FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_INVALID_ARGUMENT, formatHelp);
+    FreeRTOS_CLISetStatus(cliSTATUS_FAILED);
+
+    return pdFALSE;
+}
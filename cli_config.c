@@ -0,0 +1,1066 @@
+/**
+ * @file cli_config.c
+ * @brief Implementation of the persistent key-value configuration store.
+ *
+ * @details
+ * The storage area is split into CLI_CONFIG_SECTOR_COUNT sectors. Each sector
+ * starts with a header holding a magic number and a sequence number; the valid
+ * sector with the highest sequence number is the active one. Records follow
+ * the header back to back, each one a 4-byte header, the key and the value,
+ * padded to a multiple of 4 bytes. A record with an empty value deletes its key.
+ * The first erased byte marks the end of the log.
+ *
+ * When a commit does not fit in the active sector, the live records are copied
+ * into the next sector, whose header is written last. A power loss during the
+ * copy therefore leaves the previous sector active and intact.
+ *
+ * @date Created on 17.10.2026
+ * @author Yauheni Bialkou
+ */
+
+//======================================================================[ INCLUDE ]======================================================================================================== //
+
+#include "cli_config.h"
+#include "task.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+
+//======================================================================[ INTERNAL MACRO DEFENITIONS ]===================================================================================== //
+
+#define CLI_CONFIG_SECTOR_MAGIC 0x31474643UL // "CFG1", marks a valid sector header
+#define CLI_CONFIG_RECORD_VALID 0x5A         // State byte of a completely written record
+#define CLI_CONFIG_ERASED 0xFF               // Value of an erased flash byte
+
+#define CLI_CONFIG_INDEX_EMPTY 0xFFFFFFFFUL   // Index slot never used
+#define CLI_CONFIG_INDEX_DELETED 0xFFFFFFFEUL // Index slot whose key was deleted
+
+#define CLI_CONFIG_ALIGN(length) (((length) + 3U) & ~3U) // Rounds a length up to the record alignment
+#define CLI_CONFIG_MAX_RECORD_SIZE CLI_CONFIG_ALIGN(sizeof(CliConfigRecord_s) + CLI_CONFIG_MAX_KEY_LENGTH + CLI_CONFIG_MAX_VALUE_LENGTH)
+
+//======================================================================[ INTERNAL DATA TYPES DEFINITIONS ]================================================================================ //
+
+/**
+ * @brief Header at the start of every sector.
+ */
+typedef struct
+{
+    uint32_t magic;    // CLI_CONFIG_SECTOR_MAGIC if the sector is valid
+    uint32_t sequence; // Incremented each time the records are moved to another sector
+} CliConfigSector_s;
+
+/**
+ * @brief Header of every record.
+ */
+typedef struct
+{
+    uint8_t state;       // CLI_CONFIG_RECORD_VALID, or CLI_CONFIG_ERASED at the end of the log
+    uint8_t keyLength;   // Length of the key that follows the header
+    uint8_t valueLength; // Length of the value that follows the key, 0 for a deletion
+    uint8_t checksum;    // Checksum of the lengths, key and value
+} CliConfigRecord_s;
+
+/**
+ * @brief Slot of the RAM index.
+ */
+typedef struct
+{
+    uint16_t hash;    // Hash of the key
+    uint32_t address; // Flash address of the key's latest record, or CLI_CONFIG_INDEX_EMPTY/DELETED
+} CliConfigIndexEntry_s;
+
+/**
+ * @brief Structure holding the state of the configuration store.
+ */
+typedef struct
+{
+    CliConfigIndexEntry_s index[CLI_CONFIG_INDEX_SIZE]; // Latest record of every live key
+    uint16_t liveKeys;                                  // Number of keys in the index
+    uint8_t pending[CLI_CONFIG_PENDING_SIZE];           // Staged records, in flash format
+    uint16_t pendingLength;                             // Bytes used in the staging buffer
+    uint16_t pendingCount;                              // Number of staged records
+    uint8_t activeSector;                               // Sector new records are appended to
+    uint32_t sequence;                                  // Sequence number of the active sector
+    uint32_t writeOffset;                               // Offset of the end of the log in the active sector
+    bool needsCompaction;                               // The end of the log is not erased and cannot be appended to
+    uint8_t record[CLI_CONFIG_MAX_RECORD_SIZE];         // Scratch buffer for one record
+    CliConfigStats_s stats;                             // Measurements
+} CliConfig_s;
+
+//======================================================================[ INTERNAL FUNCTIONS AND OBJECTS DECLARATION ]===================================================================== //
+
+static CliConfig_s cliConfig = {0}; // State of the configuration store
+
+/**
+ * @brief Command callback function for the "config" command.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the subcommand and its parameters;
+ * \return     pdTRUE if more output follows, otherwise pdFALSE.
+ */
+static BaseType_t cliConfigCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
+
+/**
+ * @brief Writes as many committed keys as fit into the output buffer.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \return     pdTRUE if more keys follow, otherwise pdFALSE.
+ */
+static BaseType_t cliConfigList(char *pcWriteBuffer, size_t xWriteBufferLen);
+
+/**
+ * @brief Finds the active sector and rebuilds the index from its log.
+ *
+ * \param[in]  none;
+ * \return     int16_t - CLI_CONFIG_OK or negative CliConfigStatus_e value.
+ */
+static int16_t cliConfigMount(void);
+
+/**
+ * @brief Returns the flash address of a sector.
+ *
+ * \param[in]  sector - Sector number;
+ * \return     uint32_t - Address of the sector header.
+ */
+static uint32_t cliConfigSectorAddress(uint8_t sector);
+
+/**
+ * @brief Hashes a key.
+ *
+ * \param[in]  key    - Key characters;
+ * \param[in]  length - Key length;
+ * \return     uint16_t - Hash of the key.
+ */
+static uint16_t cliConfigHash(const char *key, uint8_t length);
+
+/**
+ * @brief Computes the checksum of a record.
+ *
+ * \param[in]  record - Record header followed by key and value;
+ * \return     uint8_t - Checksum of the record.
+ */
+static uint8_t cliConfigChecksum(const uint8_t *record);
+
+/**
+ * @brief Reads a record from flash into the scratch buffer and validates it.
+ *
+ * \param[in]  address - Flash address of the record;
+ * \param[in]  limit   - Flash address the record must end before;
+ * \return     uint32_t - Aligned size of the record, 0 if there is no valid record.
+ */
+static uint32_t cliConfigReadRecord(uint32_t address, uint32_t limit);
+
+/**
+ * @brief Looks a key up in the index.
+ *
+ * \param[in]  key    - Key characters;
+ * \param[in]  length - Key length;
+ * \param[out] slot   - Slot of the key, or the first free slot it could be stored in;
+ * \return     bool - true if the key was found.
+ */
+static bool cliConfigIndexFind(const char *key, uint8_t length, uint16_t *slot);
+
+/**
+ * @brief Updates the index with a record.
+ *
+ * \param[in]  record  - Record header followed by key and value;
+ * \param[in]  address - Flash address of the record;
+ * \return     int16_t - CLI_CONFIG_OK, or CLI_CONFIG_ERR_FULL if the index is full.
+ */
+static int16_t cliConfigIndexUpdate(const uint8_t *record, uint32_t address);
+
+/**
+ * @brief Erases a sector.
+ *
+ * \param[in]  sector - Sector number;
+ * \return     int16_t - CLI_CONFIG_OK or CLI_CONFIG_ERR_FLASH.
+ */
+static int16_t cliConfigEraseSector(uint8_t sector);
+
+/**
+ * @brief Appends data to flash.
+ *
+ * \param[in]  address - Flash address to write to;
+ * \param[in]  data    - Data to write;
+ * \param[in]  length  - Number of bytes to write;
+ * \return     int16_t - CLI_CONFIG_OK or CLI_CONFIG_ERR_FLASH.
+ */
+static int16_t cliConfigAppend(uint32_t address, const void *data, uint32_t length);
+
+/**
+ * @brief Moves the live records into the next sector.
+ *
+ * \param[in]  none;
+ * \return     int16_t - CLI_CONFIG_OK or negative CliConfigStatus_e value.
+ */
+static int16_t cliConfigCompact(void);
+
+/**
+ * @brief Finds the latest staged record of a key.
+ *
+ * \param[in]  key    - Key characters;
+ * \param[in]  length - Key length;
+ * \return     const uint8_t * - Staged record, NULL if the key has no staged change.
+ */
+static const uint8_t *cliConfigFindPending(const char *key, uint8_t length);
+
+/**
+ * @brief Command definition of the "config" command.
+ */
+static const CLI_Command_Definition_t cliConfigDefinition =
+    {
+        .pcCommand = "config",
+        .pcHelpString = "config get <key> | set <key> [value] | list | commit | stats - device configuration \r\n",
+        .pxCommandInterpreter = cliConfigCommand,
+        .cExpectedNumberOfParameters = -1,
+};
+
+//=======================================================================[PUBLIC INTERFACE FUNCTIONS]===================================================================================== //
+
+/**
+ * @brief Mounts the configuration store.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return int16_t - CLI_CONFIG_OK on success, negative CliConfigStatus_e value on failure.
+ */
+int16_t CliConfigInit(void)
+{
+    memset(&cliConfig, 0, sizeof(cliConfig));
+
+    return cliConfigMount();
+}
+
+/**
+ * @brief Reads the value of a key.
+ *
+ * \param[in]  key   - Null-terminated key;
+ * \param[out] value - Buffer receiving the null-terminated value;
+ * \param[in]  size  - Size of the value buffer;
+ * \return int16_t - Length of the value on success, negative CliConfigStatus_e value on failure.
+ */
+int16_t CliConfigGet(const char *key, char *value, uint16_t size)
+{
+    size_t keyLength = strlen(key);
+    const uint8_t *record = NULL;
+    uint16_t slot = 0;
+
+    if ((keyLength == 0) ||
+        (keyLength > CLI_CONFIG_MAX_KEY_LENGTH) ||
+        (value == NULL) ||
+        (size == 0))
+    {
+        return CLI_CONFIG_ERR_INVALID;
+    }
+
+    /* A staged change takes precedence over the committed value */
+    record = cliConfigFindPending(key, (uint8_t)keyLength);
+
+    if ((record == NULL) &&
+        (cliConfigIndexFind(key, (uint8_t)keyLength, &slot)))
+    {
+        /* cliConfigIndexFind() left the key's record in the scratch buffer */
+        record = cliConfig.record;
+    }
+
+    if ((record == NULL) ||
+        (((const CliConfigRecord_s *)record)->valueLength == 0))
+    {
+        return CLI_CONFIG_ERR_NOT_FOUND;
+    }
+
+    const CliConfigRecord_s *header = (const CliConfigRecord_s *)record;
+    uint16_t length = (header->valueLength < size) ? header->valueLength : (size - 1);
+
+    memcpy(value, &record[sizeof(CliConfigRecord_s) + header->keyLength], length);
+    value[length] = '\0';
+
+    return (int16_t)length;
+}
+
+/**
+ * @brief Stages a change of a key.
+ *
+ * \param[in]  key   - Null-terminated key without spaces;
+ * \param[in]  value - Null-terminated value, or NULL to delete the key;
+ * \param[out] none;
+ * \return int16_t - CLI_CONFIG_OK on success, negative CliConfigStatus_e value on failure.
+ */
+int16_t CliConfigSet(const char *key, const char *value)
+{
+    size_t keyLength = strlen(key);
+    size_t valueLength = (value != NULL) ? strlen(value) : 0;
+    uint32_t size = CLI_CONFIG_ALIGN(sizeof(CliConfigRecord_s) + keyLength + valueLength);
+    uint16_t slot = 0;
+
+    if ((keyLength == 0) ||
+        (keyLength > CLI_CONFIG_MAX_KEY_LENGTH) ||
+        (valueLength > CLI_CONFIG_MAX_VALUE_LENGTH) ||
+        (strchr(key, ' ') != NULL))
+    {
+        return CLI_CONFIG_ERR_INVALID;
+    }
+
+    if (size > (uint32_t)(CLI_CONFIG_PENDING_SIZE - cliConfig.pendingLength))
+    {
+        return CLI_CONFIG_ERR_PENDING_FULL;
+    }
+
+    /* Keep one index slot free so that probing always terminates */
+    if ((valueLength != 0) &&
+        (cliConfigFindPending(key, (uint8_t)keyLength) == NULL) &&
+        (!cliConfigIndexFind(key, (uint8_t)keyLength, &slot)) &&
+        ((cliConfig.liveKeys + cliConfig.pendingCount) >= (CLI_CONFIG_INDEX_SIZE - 1)))
+    {
+        return CLI_CONFIG_ERR_FULL;
+    }
+
+    uint8_t *record = &cliConfig.pending[cliConfig.pendingLength];
+    CliConfigRecord_s *header = (CliConfigRecord_s *)record;
+
+    memset(record, CLI_CONFIG_ERASED, size);
+    header->state = CLI_CONFIG_RECORD_VALID;
+    header->keyLength = (uint8_t)keyLength;
+    header->valueLength = (uint8_t)valueLength;
+    memcpy(&record[sizeof(CliConfigRecord_s)], key, keyLength);
+    memcpy(&record[sizeof(CliConfigRecord_s) + keyLength], value, valueLength);
+    header->checksum = cliConfigChecksum(record);
+
+    cliConfig.pendingLength += (uint16_t)size;
+    cliConfig.pendingCount++;
+
+    return CLI_CONFIG_OK;
+}
+
+/**
+ * @brief Writes all staged changes to flash.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return int16_t - Number of changes committed on success, negative CliConfigStatus_e value on failure.
+ */
+int16_t CliConfigCommit(void)
+{
+    int16_t status = CLI_CONFIG_OK;
+    TickType_t start = xTaskGetTickCount();
+
+    do
+    {
+        if (cliConfig.pendingCount == 0)
+        {
+            break;
+        }
+
+        /* Move to a fresh sector if the staged records do not fit behind the log */
+        if ((cliConfig.needsCompaction) ||
+            (cliConfig.pendingLength > (CLI_CONFIG_SECTOR_SIZE - cliConfig.writeOffset)))
+        {
+            status = cliConfigCompact();
+            if (status != CLI_CONFIG_OK)
+            {
+                break;
+            }
+
+            if (cliConfig.pendingLength > (CLI_CONFIG_SECTOR_SIZE - cliConfig.writeOffset))
+            {
+                status = CLI_CONFIG_ERR_FULL;
+                break;
+            }
+        }
+
+        /* All staged records are written with a single append */
+        uint32_t address = cliConfigSectorAddress(cliConfig.activeSector) + cliConfig.writeOffset;
+
+        status = cliConfigAppend(address, cliConfig.pending, cliConfig.pendingLength);
+        if (status != CLI_CONFIG_OK)
+        {
+            cliConfig.needsCompaction = true;
+            break;
+        }
+
+        /* Point the index at the new records */
+        for (uint16_t offset = 0; offset < cliConfig.pendingLength;)
+        {
+            const CliConfigRecord_s *header = (const CliConfigRecord_s *)&cliConfig.pending[offset];
+
+            (void)cliConfigIndexUpdate(&cliConfig.pending[offset], address + offset);
+            cliConfig.stats.payloadBytes += header->keyLength + header->valueLength;
+            offset += CLI_CONFIG_ALIGN(sizeof(CliConfigRecord_s) + header->keyLength + header->valueLength);
+        }
+
+        cliConfig.writeOffset += cliConfig.pendingLength;
+        status = (int16_t)cliConfig.pendingCount;
+        cliConfig.pendingLength = 0;
+        cliConfig.pendingCount = 0;
+
+        cliConfig.stats.commits++;
+        cliConfig.stats.commitLast = xTaskGetTickCount() - start;
+        if (cliConfig.stats.commitLast > cliConfig.stats.commitMax)
+        {
+            cliConfig.stats.commitMax = cliConfig.stats.commitLast;
+        }
+
+    } while (0);
+
+    return status;
+}
+
+/**
+ * @brief Iterates over the committed keys.
+ *
+ * \param[in,out] cursor - Iteration state, set to 0 before the first call;
+ * \param[out]    key    - Buffer receiving the key;
+ * \param[out]    value  - Buffer receiving the value;
+ * \return int16_t - CLI_CONFIG_OK if a key was returned, CLI_CONFIG_ERR_NOT_FOUND after the last key.
+ */
+int16_t CliConfigGetNext(uint16_t *cursor, char *key, char *value)
+{
+    int16_t status = CLI_CONFIG_ERR_NOT_FOUND;
+
+    while (*cursor < CLI_CONFIG_INDEX_SIZE)
+    {
+        CliConfigIndexEntry_s *entry = &cliConfig.index[(*cursor)++];
+
+        if ((entry->address == CLI_CONFIG_INDEX_EMPTY) ||
+            (entry->address == CLI_CONFIG_INDEX_DELETED) ||
+            (cliConfigReadRecord(entry->address, entry->address + CLI_CONFIG_MAX_RECORD_SIZE) == 0))
+        {
+            continue;
+        }
+
+        const CliConfigRecord_s *header = (const CliConfigRecord_s *)cliConfig.record;
+
+        memcpy(key, &cliConfig.record[sizeof(CliConfigRecord_s)], header->keyLength);
+        key[header->keyLength] = '\0';
+        memcpy(value, &cliConfig.record[sizeof(CliConfigRecord_s) + header->keyLength], header->valueLength);
+        value[header->valueLength] = '\0';
+
+        status = CLI_CONFIG_OK;
+        break;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Returns the measurements of the configuration store.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return const CliConfigStats_s * - Pointer to the measurements.
+ */
+const CliConfigStats_s *CliConfigGetStats(void)
+{
+    return &cliConfig.stats;
+}
+
+/**
+ * @brief Registers the "config" command with FreeRTOS CLI.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return int16_t - 0 on success, negative value on error.
+ */
+int16_t CliConfigCmdInit(void)
+{
+    int16_t status = CliConfigInit();
+
+    if (FreeRTOS_CLIRegisterCommand(&cliConfigDefinition) != pdPASS)
+    {
+        status = -1;
+    }
+
+    return status;
+}
+
+//=====================================================================[ PRIVATE FUNCTIONS ]============================================================================================== //
+
+/**
+ * @brief Command callback function for the "config" command.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the subcommand and its parameters;
+ * \return     pdTRUE if more output follows, otherwise pdFALSE.
+ */
+static BaseType_t cliConfigCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString)
+{
+    BaseType_t subLength = 0;
+    BaseType_t keyLength = 0;
+    const char *sub = FreeRTOS_CLIGetParameter(pcCommandString, 1, &subLength);
+    const char *keyParam = FreeRTOS_CLIGetParameter(pcCommandString, 2, &keyLength);
+    char key[CLI_CONFIG_MAX_KEY_LENGTH + 1] = {0};
+    char value[CLI_CONFIG_MAX_VALUE_LENGTH + 1] = {0};
+    int16_t status = CLI_CONFIG_OK;
+
+    if ((pcWriteBuffer == NULL) ||
+        (xWriteBufferLen == 0))
+    {
+        return pdFALSE;
+    }
+
+    if (sub == NULL)
+    {
+        subLength = 0;
+    }
+
+    if ((keyParam != NULL) &&
+        (keyLength <= CLI_CONFIG_MAX_KEY_LENGTH))
+    {
+        memcpy(key, keyParam, keyLength);
+    }
+
+    if ((subLength == 4) && (strncmp(sub, "list", 4) == 0))
+    {
+        return cliConfigList(pcWriteBuffer, xWriteBufferLen);
+    }
+    else if ((subLength == 3) && (strncmp(sub, "get", 3) == 0) && (key[0] != '\0'))
+    {
+        status = CliConfigGet(key, value, sizeof(value));
+        if (status >= 0)
+        {
+            snprintf(pcWriteBuffer, xWriteBufferLen, "%s\r\n", value);
+        }
+    }
+    else if ((subLength == 3) && (strncmp(sub, "set", 3) == 0) && (key[0] != '\0'))
+    {
+        /* The value is the rest of the line after the key, and may contain spaces */
+        const char *valueParam = keyParam + keyLength;
+
+        while (*valueParam == ' ')
+        {
+            valueParam++;
+        }
+
+        status = CliConfigSet(key, (*valueParam != '\0') ? valueParam : NULL);
+        if (status == CLI_CONFIG_OK)
+        {
+            snprintf(pcWriteBuffer, xWriteBufferLen, "OK (commit to save)\r\n");
+        }
+    }
+    else if ((subLength == 6) && (strncmp(sub, "commit", 6) == 0))
+    {
+        status = CliConfigCommit();
+        if (status >= 0)
+        {
+            snprintf(pcWriteBuffer, xWriteBufferLen, "Committed %d change(s) in %lu tick(s)\r\n",
+                     status, (unsigned long)((status > 0) ? cliConfig.stats.commitLast : 0));
+        }
+    }
+    else if ((subLength == 5) && (strncmp(sub, "stats", 5) == 0))
+    {
+        const CliConfigStats_s *stats = &cliConfig.stats;
+        uint32_t amplification = (stats->payloadBytes != 0) ? ((stats->flashBytes * 100UL) / stats->payloadBytes) : 0;
+        CLI_Record_t record;
+
+        /* Write amplification is reported in hundredths */
+        FreeRTOS_CLIRecordInit(&record, pcWriteBuffer, xWriteBufferLen);
+        FreeRTOS_CLIRecordBegin(&record);
+        FreeRTOS_CLIRecordString(&record, "store", "config");
+        FreeRTOS_CLIRecordUnsigned(&record, "keys", cliConfig.liveKeys);
+        FreeRTOS_CLIRecordUnsigned(&record, "sector", cliConfig.activeSector);
+        FreeRTOS_CLIRecordUnsigned(&record, "used", cliConfig.writeOffset);
+        FreeRTOS_CLIRecordUnsigned(&record, "size", CLI_CONFIG_SECTOR_SIZE);
+        FreeRTOS_CLIRecordUnsigned(&record, "erases", stats->erases);
+        FreeRTOS_CLIRecordUnsigned(&record, "payload", stats->payloadBytes);
+        FreeRTOS_CLIRecordUnsigned(&record, "flash", stats->flashBytes);
+        FreeRTOS_CLIRecordUnsigned(&record, "amplification", amplification);
+        FreeRTOS_CLIRecordUnsigned(&record, "commits", stats->commits);
+        FreeRTOS_CLIRecordUnsigned(&record, "last", stats->commitLast);
+        FreeRTOS_CLIRecordUnsigned(&record, "max", stats->commitMax);
+        (void)FreeRTOS_CLIRecordEnd(&record);
+    }
+    else
+    {
+        status = CLI_CONFIG_ERR_INVALID;
+    }
+
+    switch (status)
+    {
+    case CLI_CONFIG_ERR_NOT_FOUND:
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_NOT_FOUND, "Key not found\r\n");
+        break;
+
+    case CLI_CONFIG_ERR_INVALID:
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_INVALID_ARGUMENT, cliConfigDefinition.pcHelpString);
+        break;
+
+    case CLI_CONFIG_ERR_PENDING_FULL:
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_PENDING_FULL, NULL);
+        break;
+
+    case CLI_CONFIG_ERR_FULL:
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_FULL, "Configuration store is full\r\n");
+        break;
+
+    case CLI_CONFIG_ERR_FLASH:
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_FLASH, NULL);
+        break;
+
+    default:
+        break;
+    }
+
+    if (status < 0)
+    {
+        FreeRTOS_CLISetStatus(cliSTATUS_FAILED);
+    }
+
+    return pdFALSE;
+}
+
+/**
+ * @brief Writes as many committed keys as fit into the output buffer.
+ *
+ * The iteration cursor is kept in the command context between calls.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \return     pdTRUE if more keys follow, otherwise pdFALSE.
+ */
+static BaseType_t cliConfigList(char *pcWriteBuffer, size_t xWriteBufferLen)
+{
+    CLI_Command_Context_t *context = FreeRTOS_CLIGetContext();
+    char key[CLI_CONFIG_MAX_KEY_LENGTH + 1] = {0};
+    char value[CLI_CONFIG_MAX_VALUE_LENGTH + 1] = {0};
+    bool firstChunk = (context->uxIndex == 0);
+    CLI_Record_t record;
+
+    FreeRTOS_CLIRecordInit(&record, pcWriteBuffer, xWriteBufferLen);
+
+    while (1)
+    {
+        uint16_t cursor = (uint16_t)context->uxIndex;
+
+        if (CliConfigGetNext(&cursor, key, value) != CLI_CONFIG_OK)
+        {
+            if (firstChunk &&
+                (FreeRTOS_CLIRecordLength(&record) == 0) &&
+                (FreeRTOS_CLIGetFormat() == cliFORMAT_TEXT))
+            {
+                snprintf(pcWriteBuffer, xWriteBufferLen, "No keys\r\n");
+            }
+            return pdFALSE;
+        }
+
+        FreeRTOS_CLIRecordBegin(&record);
+        FreeRTOS_CLIRecordString(&record, "key", key);
+        FreeRTOS_CLIRecordString(&record, "value", value);
+
+        if ((FreeRTOS_CLIRecordEnd(&record) != pdPASS) &&
+            (FreeRTOS_CLIRecordLength(&record) != 0))
+        {
+            /* The record does not fit, send it with the next chunk */
+            return pdTRUE;
+        }
+
+        firstChunk = false;
+        context->uxIndex = cursor;
+    }
+}
+
+/**
+ * @brief Finds the active sector and rebuilds the index from its log.
+ *
+ * Staged changes and measurements are preserved.
+ *
+ * \param[in]  none;
+ * \return     int16_t - CLI_CONFIG_OK or negative CliConfigStatus_e value.
+ */
+static int16_t cliConfigMount(void)
+{
+    int16_t status = CLI_CONFIG_OK;
+    CliConfigSector_s header = {0};
+    bool found = false;
+
+    memset(cliConfig.index, CLI_CONFIG_ERASED, sizeof(cliConfig.index));
+    cliConfig.liveKeys = 0;
+    cliConfig.needsCompaction = false;
+
+    do
+    {
+        /* Find the valid sector with the most recent sequence number */
+        for (uint8_t sector = 0; sector < CLI_CONFIG_SECTOR_COUNT; sector++)
+        {
+            if (flash_read(&CLI_CONFIG_FLASH, cliConfigSectorAddress(sector), (uint8_t *)&header, sizeof(header)) != ERR_NONE)
+            {
+                status = CLI_CONFIG_ERR_FLASH;
+                break;
+            }
+
+            if ((header.magic == CLI_CONFIG_SECTOR_MAGIC) &&
+                ((!found) || ((int32_t)(header.sequence - cliConfig.sequence) > 0)))
+            {
+                found = true;
+                cliConfig.activeSector = sector;
+                cliConfig.sequence = header.sequence;
+            }
+        }
+
+        if (status != CLI_CONFIG_OK)
+        {
+            break;
+        }
+
+        /* Format the storage area if it holds no valid sector */
+        if (!found)
+        {
+            header.magic = CLI_CONFIG_SECTOR_MAGIC;
+            header.sequence = 1;
+
+            status = cliConfigEraseSector(0);
+            if (status == CLI_CONFIG_OK)
+            {
+                status = cliConfigAppend(cliConfigSectorAddress(0), &header, sizeof(header));
+            }
+
+            cliConfig.activeSector = 0;
+            cliConfig.sequence = header.sequence;
+            cliConfig.writeOffset = sizeof(header);
+            break;
+        }
+
+        /* Replay the log of the active sector into the index */
+        uint32_t address = cliConfigSectorAddress(cliConfig.activeSector) + sizeof(CliConfigSector_s);
+        uint32_t limit = cliConfigSectorAddress(cliConfig.activeSector) + CLI_CONFIG_SECTOR_SIZE;
+
+        while (address < limit)
+        {
+            uint32_t size = cliConfigReadRecord(address, limit);
+            if (size == 0)
+            {
+                /* Anything but erased flash here is a record torn by a power loss */
+                cliConfig.needsCompaction = (cliConfig.record[0] != CLI_CONFIG_ERASED);
+                break;
+            }
+
+            (void)cliConfigIndexUpdate(cliConfig.record, address);
+            address += size;
+        }
+
+        cliConfig.writeOffset = address - cliConfigSectorAddress(cliConfig.activeSector);
+
+    } while (0);
+
+    return status;
+}
+
+/**
+ * @brief Returns the flash address of a sector.
+ *
+ * \param[in]  sector - Sector number;
+ * \return     uint32_t - Address of the sector header.
+ */
+static uint32_t cliConfigSectorAddress(uint8_t sector)
+{
+    return CLI_CONFIG_FLASH_ADDRESS + ((uint32_t)sector * CLI_CONFIG_SECTOR_SIZE);
+}
+
+/**
+ * @brief Hashes a key.
+ *
+ * 32-bit FNV-1a folded to 16 bits.
+ *
+ * \param[in]  key    - Key characters;
+ * \param[in]  length - Key length;
+ * \return     uint16_t - Hash of the key.
+ */
+static uint16_t cliConfigHash(const char *key, uint8_t length)
+{
+    uint32_t hash = 2166136261UL;
+
+    for (uint8_t ind = 0; ind < length; ind++)
+    {
+        hash ^= (uint8_t)key[ind];
+        hash *= 16777619UL;
+    }
+
+    return (uint16_t)(hash ^ (hash >> 16));
+}
+
+/**
+ * @brief Computes the checksum of a record.
+ *
+ * \param[in]  record - Record header followed by key and value;
+ * \return     uint8_t - Checksum of the record.
+ */
+static uint8_t cliConfigChecksum(const uint8_t *record)
+{
+    const CliConfigRecord_s *header = (const CliConfigRecord_s *)record;
+    uint8_t sum = header->keyLength + header->valueLength;
+
+    for (uint16_t ind = 0; ind < (uint16_t)(header->keyLength + header->valueLength); ind++)
+    {
+        sum += record[sizeof(CliConfigRecord_s) + ind];
+    }
+
+    /* An all-zero or all-erased record must not pass */
+    return (uint8_t)~sum;
+}
+
+/**
+ * @brief Reads a record from flash into the scratch buffer and validates it.
+ *
+ * \param[in]  address - Flash address of the record;
+ * \param[in]  limit   - Flash address the record must end before;
+ * \return     uint32_t - Aligned size of the record, 0 if there is no valid record.
+ */
+static uint32_t cliConfigReadRecord(uint32_t address, uint32_t limit)
+{
+    CliConfigRecord_s *header = (CliConfigRecord_s *)cliConfig.record;
+    uint32_t size = 0;
+
+    do
+    {
+        if ((limit - address) < sizeof(CliConfigRecord_s))
+        {
+            header->state = CLI_CONFIG_ERASED;
+            break;
+        }
+
+        if (flash_read(&CLI_CONFIG_FLASH, address, cliConfig.record, sizeof(CliConfigRecord_s)) != ERR_NONE)
+        {
+            break;
+        }
+
+        if ((header->state != CLI_CONFIG_RECORD_VALID) ||
+            (header->keyLength == 0) ||
+            (header->keyLength > CLI_CONFIG_MAX_KEY_LENGTH) ||
+            (header->valueLength > CLI_CONFIG_MAX_VALUE_LENGTH))
+        {
+            break;
+        }
+
+        uint32_t recordSize = CLI_CONFIG_ALIGN(sizeof(CliConfigRecord_s) + header->keyLength + header->valueLength);
+
+        if ((recordSize > (limit - address)) ||
+            (flash_read(&CLI_CONFIG_FLASH,
+                        address + sizeof(CliConfigRecord_s),
+                        &cliConfig.record[sizeof(CliConfigRecord_s)],
+                        recordSize - sizeof(CliConfigRecord_s)) != ERR_NONE))
+        {
+            break;
+        }
+
+        if (header->checksum != cliConfigChecksum(cliConfig.record))
+        {
+            break;
+        }
+
+        size = recordSize;
+
+    } while (0);
+
+    return size;
+}
+
+/**
+ * @brief Looks a key up in the index.
+ *
+ * On success the key's record is left in the scratch buffer.
+ *
+ * \param[in]  key    - Key characters;
+ * \param[in]  length - Key length;
+ * \param[out] slot   - Slot of the key, or the first free slot it could be stored in;
+ * \return     bool - true if the key was found.
+ */
+static bool cliConfigIndexFind(const char *key, uint8_t length, uint16_t *slot)
+{
+    uint16_t hash = cliConfigHash(key, length);
+    uint16_t ind = hash & (CLI_CONFIG_INDEX_SIZE - 1);
+    bool freeFound = false;
+
+    for (uint16_t probe = 0; probe < CLI_CONFIG_INDEX_SIZE; probe++, ind = (ind + 1) & (CLI_CONFIG_INDEX_SIZE - 1))
+    {
+        CliConfigIndexEntry_s *entry = &cliConfig.index[ind];
+
+        if ((entry->address == CLI_CONFIG_INDEX_EMPTY) ||
+            (entry->address == CLI_CONFIG_INDEX_DELETED))
+        {
+            if (!freeFound)
+            {
+                freeFound = true;
+                *slot = ind;
+            }
+
+            if (entry->address == CLI_CONFIG_INDEX_EMPTY)
+            {
+                break;
+            }
+
+            continue;
+        }
+
+        /* Only a hash match costs a flash read to compare the key */
+        if ((entry->hash == hash) &&
+            (cliConfigReadRecord(entry->address, entry->address + CLI_CONFIG_MAX_RECORD_SIZE) != 0) &&
+            (((const CliConfigRecord_s *)cliConfig.record)->keyLength == length) &&
+            (memcmp(&cliConfig.record[sizeof(CliConfigRecord_s)], key, length) == 0))
+        {
+            *slot = ind;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Updates the index with a record.
+ *
+ * \param[in]  record  - Record header followed by key and value;
+ * \param[in]  address - Flash address of the record;
+ * \return     int16_t - CLI_CONFIG_OK, or CLI_CONFIG_ERR_FULL if the index is full.
+ */
+static int16_t cliConfigIndexUpdate(const uint8_t *record, uint32_t address)
+{
+    const CliConfigRecord_s *header = (const CliConfigRecord_s *)record;
+    const char *key = (const char *)&record[sizeof(CliConfigRecord_s)];
+    uint16_t slot = CLI_CONFIG_INDEX_SIZE;
+    char keyCopy[CLI_CONFIG_MAX_KEY_LENGTH];
+
+    /* The record may live in the scratch buffer, which the lookup reuses */
+    memcpy(keyCopy, key, header->keyLength);
+    uint8_t keyLength = header->keyLength;
+    bool deletion = (header->valueLength == 0);
+
+    if (cliConfigIndexFind(keyCopy, keyLength, &slot))
+    {
+        if (deletion)
+        {
+            cliConfig.index[slot].address = CLI_CONFIG_INDEX_DELETED;
+            cliConfig.liveKeys--;
+        }
+        else
+        {
+            cliConfig.index[slot].address = address;
+        }
+    }
+    else if (!deletion)
+    {
+        if (slot >= CLI_CONFIG_INDEX_SIZE)
+        {
+            return CLI_CONFIG_ERR_FULL;
+        }
+
+        cliConfig.index[slot].hash = cliConfigHash(keyCopy, keyLength);
+        cliConfig.index[slot].address = address;
+        cliConfig.liveKeys++;
+    }
+
+    return CLI_CONFIG_OK;
+}
+
+/**
+ * @brief Erases a sector.
+ *
+ * \param[in]  sector - Sector number;
+ * \return     int16_t - CLI_CONFIG_OK or CLI_CONFIG_ERR_FLASH.
+ */
+static int16_t cliConfigEraseSector(uint8_t sector)
+{
+    uint32_t pages = CLI_CONFIG_SECTOR_SIZE / flash_get_page_size(&CLI_CONFIG_FLASH);
+
+    cliConfig.stats.erases++;
+
+    return (flash_erase(&CLI_CONFIG_FLASH, cliConfigSectorAddress(sector), pages) == ERR_NONE) ? CLI_CONFIG_OK : CLI_CONFIG_ERR_FLASH;
+}
+
+/**
+ * @brief Appends data to flash.
+ *
+ * Appending programs erased flash without a read-modify-erase cycle.
+ *
+ * \param[in]  address - Flash address to write to;
+ * \param[in]  data    - Data to write;
+ * \param[in]  length  - Number of bytes to write;
+ * \return     int16_t - CLI_CONFIG_OK or CLI_CONFIG_ERR_FLASH.
+ */
+static int16_t cliConfigAppend(uint32_t address, const void *data, uint32_t length)
+{
+    cliConfig.stats.flashBytes += length;
+
+    return (flash_append(&CLI_CONFIG_FLASH, address, (uint8_t *)data, length) == ERR_NONE) ? CLI_CONFIG_OK : CLI_CONFIG_ERR_FLASH;
+}
+
+/**
+ * @brief Moves the live records into the next sector.
+ *
+ * The sectors are used in turn, so erases are spread evenly over the area.
+ * The header of the new sector is written after all records have been copied.
+ *
+ * \param[in]  none;
+ * \return     int16_t - CLI_CONFIG_OK or negative CliConfigStatus_e value.
+ */
+static int16_t cliConfigCompact(void)
+{
+    uint8_t target = (uint8_t)((cliConfig.activeSector + 1) % CLI_CONFIG_SECTOR_COUNT);
+    uint32_t base = cliConfigSectorAddress(target);
+    uint32_t offset = sizeof(CliConfigSector_s);
+    CliConfigSector_s header = {CLI_CONFIG_SECTOR_MAGIC, cliConfig.sequence + 1};
+    int16_t status = cliConfigEraseSector(target);
+
+    for (uint16_t ind = 0; (ind < CLI_CONFIG_INDEX_SIZE) && (status == CLI_CONFIG_OK); ind++)
+    {
+        CliConfigIndexEntry_s *entry = &cliConfig.index[ind];
+
+        if ((entry->address == CLI_CONFIG_INDEX_EMPTY) ||
+            (entry->address == CLI_CONFIG_INDEX_DELETED))
+        {
+            continue;
+        }
+
+        uint32_t size = cliConfigReadRecord(entry->address, entry->address + CLI_CONFIG_MAX_RECORD_SIZE);
+        if ((size == 0) ||
+            (size > (CLI_CONFIG_SECTOR_SIZE - offset)))
+        {
+            status = CLI_CONFIG_ERR_FULL;
+            break;
+        }
+
+        status = cliConfigAppend(base + offset, cliConfig.record, size);
+        offset += size;
+    }
+
+    if (status == CLI_CONFIG_OK)
+    {
+        status = cliConfigAppend(base, &header, sizeof(header));
+    }
+
+    /* Rebuild the index from the new sector, or from the old one if the copy
+     * failed. Emptying the deleted slots in place would cut the probe chains
+     * of the keys stored past them. */
+    int16_t mountStatus = cliConfigMount();
+
+    return (status == CLI_CONFIG_OK) ? mountStatus : status;
+}
+
+/**
+ * @brief Finds the latest staged record of a key.
+ *
+ * \param[in]  key    - Key characters;
+ * \param[in]  length - Key length;
+ * \return     const uint8_t * - Staged record, NULL if the key has no staged change.
+ */
+static const uint8_t *cliConfigFindPending(const char *key, uint8_t length)
+{
+    const uint8_t *found = NULL;
+
+    for (uint16_t offset = 0; offset < cliConfig.pendingLength;)
+    {
+        const uint8_t *record = &cliConfig.pending[offset];
+        const CliConfigRecord_s *header = (const CliConfigRecord_s *)record;
+
+        if ((header->keyLength == length) &&
+            (memcmp(&record[sizeof(CliConfigRecord_s)], key, length) == 0))
+        {
+            found = record;
+        }
+
+        offset += CLI_CONFIG_ALIGN(sizeof(CliConfigRecord_s) + header->keyLength + header->valueLength);
+    }
+
+    return found;
+}
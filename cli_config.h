@@ -0,0 +1,150 @@
+/**
+ * @file cli_config.h
+ * @brief Persistent key-value configuration store for the CLI.
+ *
+ * @details
+ * This file declares a small key-value store for device configuration that is
+ * changed from the command line. Values are kept in a log-structured area of
+ * the internal flash: every change is appended as a new record, so committing
+ * a change never rewrites a whole sector. When the active sector is full, the
+ * live records are copied into the next sector in turn, which spreads erase
+ * cycles over all sectors of the area. An index in RAM maps each key to its
+ * latest record, so a read costs one hash probe and one flash read.
+ *
+ * Changes made with CliConfigSet() are staged in RAM and only written to flash
+ * by CliConfigCommit(), so a batch of changes costs one flash append.
+ *
+ * The store is not reentrant; it is meant to be used from command callbacks,
+ * which the CLI executes one at a time.
+ *
+ * @date Created on 17.10.2026
+ * @author Yauheni Bialkou
+ */
+
+#ifndef CLI_CONFIG_H
+#define CLI_CONFIG_H
+
+//================================================================[INCLUDE]================================================================================================================//
+
+#include "FreeRTOS.h"     // FreeRTOS kernel headers
+#include "FreeRTOS_CLI.h" // FreeRTOS CLI API
+#include "hal_flash.h"    // Flash driver used as the storage backend
+#include "driver_init.h"  // Hardware initialization functions (depends on your project setup)
+
+//===========================================================[MACRO DEFINITIONS]===========================================================================================================//
+
+#define CLI_CONFIG_FLASH FLASH_0              // Flash descriptor of the storage area (depends on your project setup)
+#define CLI_CONFIG_FLASH_ADDRESS 0x3C000      // Start address of the storage area (depends on your project setup)
+#define CLI_CONFIG_SECTOR_SIZE 4096           // Size of one sector of the storage area, a multiple of the erase size
+#define CLI_CONFIG_SECTOR_COUNT 4             // Number of sectors in the storage area, at least 2
+
+#define CLI_CONFIG_MAX_KEY_LENGTH 32          // Maximum length of a key, in characters
+#define CLI_CONFIG_MAX_VALUE_LENGTH 64        // Maximum length of a value, in characters
+#define CLI_CONFIG_INDEX_SIZE 64              // Number of index slots, a power of 2 larger than the number of keys
+#define CLI_CONFIG_PENDING_SIZE 512           // RAM used to stage uncommitted changes, in bytes
+
+//========================================================[DATA TYPES DEFINITIONS]=========================================================================================================//
+
+/**
+ * @brief Enumeration for configuration store statuses.
+ *
+ * Negative values are returned by the store functions on failure.
+ */
+typedef enum
+{
+    CLI_CONFIG_OK = 0,                 // Operation successful
+    CLI_CONFIG_ERR_NOT_FOUND = -1,     // The key does not exist
+    CLI_CONFIG_ERR_INVALID = -2,       // Key or value is empty, too long or contains invalid characters
+    CLI_CONFIG_ERR_PENDING_FULL = -3,  // No room left to stage the change, commit first
+    CLI_CONFIG_ERR_FULL = -4,          // The storage area or the index cannot hold any more keys
+    CLI_CONFIG_ERR_FLASH = -5          // A flash operation failed
+
+} CliConfigStatus_e;
+
+/**
+ * @brief Structure holding the measurements of the configuration store.
+ */
+typedef struct
+{
+    uint32_t payloadBytes;    // Key and value bytes committed by the application
+    uint32_t flashBytes;      // Bytes written to flash, including headers, padding and compaction copies
+    uint32_t erases;          // Number of sector erases
+    uint32_t commits;         // Number of commits
+    TickType_t commitLast;    // Duration of the last commit, in ticks
+    TickType_t commitMax;     // Duration of the longest commit, in ticks
+} CliConfigStats_s;
+
+//===========================================================[PUBLIC INTERFACE]============================================================================================================//
+
+/**
+ * @brief Mounts the configuration store.
+ *
+ * Finds the active sector, replays its records into the RAM index and formats
+ * the storage area if it holds no valid sector.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return int16_t - CLI_CONFIG_OK on success, negative CliConfigStatus_e value on failure.
+ */
+int16_t CliConfigInit(void);
+
+/**
+ * @brief Reads the value of a key.
+ *
+ * Staged changes are returned before they are committed.
+ *
+ * \param[in]  key   - Null-terminated key;
+ * \param[out] value - Buffer receiving the null-terminated value;
+ * \param[in]  size  - Size of the value buffer;
+ * \return int16_t - Length of the value on success, negative CliConfigStatus_e value on failure.
+ */
+int16_t CliConfigGet(const char *key, char *value, uint16_t size);
+
+/**
+ * @brief Stages a change of a key.
+ *
+ * \param[in]  key   - Null-terminated key without spaces;
+ * \param[in]  value - Null-terminated value, or NULL to delete the key;
+ * \param[out] none;
+ * \return int16_t - CLI_CONFIG_OK on success, negative CliConfigStatus_e value on failure.
+ */
+int16_t CliConfigSet(const char *key, const char *value);
+
+/**
+ * @brief Writes all staged changes to flash.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return int16_t - Number of changes committed on success, negative CliConfigStatus_e value on failure.
+ */
+int16_t CliConfigCommit(void);
+
+/**
+ * @brief Iterates over the committed keys.
+ *
+ * \param[in,out] cursor - Iteration state, set to 0 before the first call;
+ * \param[out]    key    - Buffer of at least CLI_CONFIG_MAX_KEY_LENGTH + 1 bytes receiving the key;
+ * \param[out]    value  - Buffer of at least CLI_CONFIG_MAX_VALUE_LENGTH + 1 bytes receiving the value;
+ * \return int16_t - CLI_CONFIG_OK if a key was returned, CLI_CONFIG_ERR_NOT_FOUND after the last key.
+ */
+int16_t CliConfigGetNext(uint16_t *cursor, char *key, char *value);
+
+/**
+ * @brief Returns the measurements of the configuration store.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return const CliConfigStats_s * - Pointer to the measurements.
+ */
+const CliConfigStats_s *CliConfigGetStats(void);
+
+/**
+ * @brief Registers the "config" command with FreeRTOS CLI.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return int16_t - 0 on success, negative value on error.
+ */
+int16_t CliConfigCmdInit(void);
+
+#endif /* CLI_CONFIG_H */
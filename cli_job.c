@@ -0,0 +1,954 @@
+/**
+ * @file cli_job.c
+ * @brief Implementation of the "at", "every" and "jobs" commands.
+ *
+ * @details
+ * The jobs waiting for their time are kept in a binary min-heap of job
+ * numbers ordered by due tick, each job knowing its position in the heap so
+ * that it can be removed from the middle when it is cancelled. After every
+ * change of the heap, the one-shot timer is re-armed for the job on top.
+ *
+ * Due ticks are compared by their signed difference, which stays correct
+ * across the wrap of the tick count as long as no job is further away than
+ * half its range.
+ *
+ * The commands of the jobs run one after the other in a context of their own,
+ * so they never disturb the context of the console session.
+ *
+ * @date Created on 17.10.2026
+ * @author Yauheni Bialkou
+ */
+
+//======================================================================[ INCLUDE ]======================================================================================================== //
+
+#include "cli_job.h"
+#include "task.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#if (CLI_JOB_COUNT > 0)
+
+//======================================================================[ INTERNAL MACRO DEFENITIONS ]===================================================================================== //
+
+#define CLI_JOB_NOT_QUEUED 0xFFU        // Heap position of a job that is not waiting for its time
+#define CLI_JOB_MS_PER_SECOND 1000UL    // Milliseconds in a second
+
+//======================================================================[ INTERNAL DATA TYPES DEFINITIONS ]================================================================================ //
+
+/**
+ * @brief One scheduled job.
+ */
+typedef struct
+{
+    char line[CLI_JOB_MAX_LENGTH + 1];   // Command line, empty if the entry is free
+    CLI_Definition_List_Item_t *command; // Command the line runs
+    TickType_t due;                      // Tick the job is due at
+    TickType_t period;                   // Period in ticks, 0 for a job run once
+    uint32_t periodMs;                   // Delay or period as it was given, in milliseconds
+    uint8_t heapIndex;                   // Position in the heap, CLI_JOB_NOT_QUEUED if the job is not waiting
+    uint8_t sink;                        // CliJobSink_e value
+    bool running;                        // The command has output left to produce
+    uint32_t start;                      // Start time of the current run
+    uint32_t runs;                       // Number of completed runs
+    uint32_t failures;                   // Number of runs that failed
+    uint32_t totalTime;                  // Sum of the run times
+    uint32_t maxTime;                    // Longest run time
+} CliJobEntry_s;
+
+/**
+ * @brief Structure holding the job state.
+ */
+typedef struct
+{
+    CliJobEntry_s entries[CLI_JOB_COUNT]; // Jobs
+    uint8_t heap[CLI_JOB_COUNT];          // Numbers of the waiting jobs, earliest due first
+    uint8_t heapCount;                    // Number of waiting jobs
+    TimerHandle_t timer;                  // One-shot timer armed for the earliest due job
+    BaseType_t (*wakeup)(void);           // Wakes the task that runs the jobs, pdFAIL if it could not
+    CLI_Command_Context_t context;        // Context of the command of the job being run
+    uint8_t arena[CLI_JOB_ARENA_SIZE];    // Scratch memory of the command of the job being run
+    char log[CLI_JOB_LOG_SIZE];           // Ring of the logged output
+    size_t logHead;                       // Offset of the oldest byte of the log
+    size_t logLength;                     // Number of bytes in the log
+} CliJob_s;
+
+//======================================================================[ INTERNAL FUNCTIONS AND OBJECTS DECLARATION ]===================================================================== //
+
+static CliJob_s cliJob = {0}; // Job state
+
+/**
+ * @brief Command callback function for the "at" command.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the delay, the optional sink and the command;
+ * \return     pdFALSE (indicates that the output has been fully written).
+ */
+static BaseType_t cliJobAtCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
+
+/**
+ * @brief Command callback function for the "every" command.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the period, the optional sink and the command;
+ * \return     pdFALSE (indicates that the output has been fully written).
+ */
+static BaseType_t cliJobEveryCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
+
+/**
+ * @brief Command callback function for the "jobs" command.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the optional subcommand;
+ * \return     pdTRUE if more output follows, otherwise pdFALSE.
+ */
+static BaseType_t cliJobsCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
+
+/**
+ * @brief Schedules a job.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string of "at" or "every";
+ * \param[in]  periodic        - The job runs every delay rather than once;
+ * \return     pdFALSE (indicates that the output has been fully written).
+ */
+static BaseType_t cliJobSchedule(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString, bool periodic);
+
+/**
+ * @brief Lists the jobs, one record per job.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \return     pdTRUE if more output follows, otherwise pdFALSE.
+ */
+static BaseType_t cliJobList(char *pcWriteBuffer, size_t xWriteBufferLen);
+
+/**
+ * @brief Parses a delay, in seconds or in milliseconds with the suffix "ms".
+ *
+ * \param[in]  text   - Delay parameter;
+ * \param[in]  length - Length of the parameter;
+ * \param[out] ms     - Delay in milliseconds;
+ * \return     bool - true if the parameter is a valid delay.
+ */
+static bool cliJobParseDelay(const char *text, BaseType_t length, uint32_t *ms);
+
+/**
+ * @brief Appends text to the job log, dropping its oldest bytes if it is full.
+ *
+ * \param[in]  text   - Text to append;
+ * \param[in]  length - Length of the text;
+ * \return     none.
+ */
+static void cliJobLog(const char *text, size_t length);
+
+/**
+ * @brief Returns true if job a is due before job b.
+ *
+ * \param[in]  a - Number of a job;
+ * \param[in]  b - Number of a job;
+ * \return     bool - true if a is due first.
+ */
+static bool cliJobBefore(uint8_t a, uint8_t b);
+
+/**
+ * @brief Stores a job at a position of the heap.
+ *
+ * \param[in]  position - Position in the heap;
+ * \param[in]  job      - Number of the job;
+ * \return     none.
+ */
+static void cliJobHeapSet(uint8_t position, uint8_t job);
+
+/**
+ * @brief Moves the job at a position of the heap up or down to its place.
+ *
+ * \param[in]  position - Position of the job in the heap;
+ * \return     none.
+ */
+static void cliJobHeapFix(uint8_t position);
+
+/**
+ * @brief Adds a job to the heap.
+ *
+ * \param[in]  job - Number of the job;
+ * \return     none.
+ */
+static void cliJobHeapPush(uint8_t job);
+
+/**
+ * @brief Removes a job from the heap.
+ *
+ * \param[in]  job - Number of a job in the heap;
+ * \return     none.
+ */
+static void cliJobHeapRemove(uint8_t job);
+
+/**
+ * @brief Cancels a scheduled job.
+ *
+ * \param[in]  job - Number of a scheduled job;
+ * \return     none.
+ */
+static void cliJobCancel(uint8_t job);
+
+/**
+ * @brief Arms the timer for the earliest due job, or stops it if no job waits.
+ *
+ * \param[in]  none;
+ * \return     none.
+ */
+static void cliJobArm(void);
+
+/**
+ * @brief Timer callback, wakes the task that runs the jobs.
+ *
+ * \param[in]  timer - Handle of the job timer;
+ * \return     none.
+ */
+static void cliJobTimerCb(TimerHandle_t timer);
+
+/**
+ * @brief Command definitions of the job commands.
+ */
+static const CLI_Command_Definition_t cliJobDefinitions[] =
+    {
+        {
+            .pcCommand = "at",
+            .pcHelpString = "at <delay>[ms] [log|console] <command...> - runs command once after delay seconds \r\n",
+            .pxCommandInterpreter = cliJobAtCommand,
+            .cExpectedNumberOfParameters = -1,
+        },
+        {
+            .pcCommand = "every",
+            .pcHelpString = "every <period>[ms] [log|console] <command...> - runs command every period seconds \r\n",
+            .pxCommandInterpreter = cliJobEveryCommand,
+            .cExpectedNumberOfParameters = -1,
+        },
+        {
+            .pcCommand = "jobs",
+            .pcHelpString = "jobs [log | cancel <job>] - lists the scheduled jobs with their statistics, reads out the job log or cancels a job \r\n",
+            .pxCommandInterpreter = cliJobsCommand,
+            .cExpectedNumberOfParameters = -1,
+        }};
+
+//=======================================================================[PUBLIC INTERFACE FUNCTIONS]===================================================================================== //
+
+/**
+ * @brief Sets the function called from the timer service task when a job is due.
+ *
+ * \param[in]  wakeup - Function waking the CLI task;
+ * \param[out] none;
+ * \return none.
+ */
+void CliJobSetWakeup(BaseType_t (*wakeup)(void))
+{
+    cliJob.wakeup = wakeup;
+}
+
+/**
+ * @brief Takes the earliest due job and reschedules it if it is periodic.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return int16_t - Number of the job to run with CliJobProcess(), -1 if no job is due.
+ */
+int16_t CliJobTake(void)
+{
+    TickType_t now = xTaskGetTickCount();
+
+    if ((cliJob.heapCount == 0) ||
+        ((int32_t)(cliJob.entries[cliJob.heap[0]].due - now) > 0))
+    {
+        return -1;
+    }
+
+    uint8_t job = cliJob.heap[0];
+    CliJobEntry_s *entry = &cliJob.entries[job];
+
+    cliJobHeapRemove(job);
+
+    if (entry->period != 0)
+    {
+        /* Keep the rate, but do not make up for runs that came too late */
+        entry->due += entry->period;
+        if ((int32_t)(entry->due - now) <= 0)
+        {
+            entry->due = now + entry->period;
+        }
+        cliJobHeapPush(job);
+    }
+
+    cliJobArm();
+
+    return job;
+}
+
+/**
+ * @brief Returns the command a job runs.
+ *
+ * \param[in]  job - Number of the job;
+ * \param[out] none;
+ * \return CLI_Definition_List_Item_t * - List item of the command, to select a worker for it.
+ */
+CLI_Definition_List_Item_t *CliJobCommand(int16_t job)
+{
+    return ((job >= 0) && (job < CLI_JOB_COUNT)) ? cliJob.entries[job].command : NULL;
+}
+
+/**
+ * @brief Runs the command of a job for one chunk of output.
+ *
+ * \param[in]  job        - Number of the job taken with CliJobTake();
+ * \param[out] output     - Buffer receiving the output of the command;
+ * \param[in]  outputSize - Size of the output buffer;
+ * \return BaseType_t - pdTRUE if more output follows, otherwise pdFALSE.
+ */
+BaseType_t CliJobProcess(int16_t job, char *output, size_t outputSize)
+{
+    CLI_Command_Context_t *outerContext = FreeRTOS_CLIGetContext();
+    CliJobEntry_s *entry = NULL;
+    BaseType_t more = pdFALSE;
+
+    if ((job < 0) ||
+        (job >= CLI_JOB_COUNT) ||
+        (cliJob.entries[job].line[0] == '\0') ||
+        (output == NULL) ||
+        (outputSize == 0))
+    {
+        return pdFALSE;
+    }
+
+    entry = &cliJob.entries[job];
+
+    if (!entry->running)
+    {
+        char header[24] = {0};
+        int headerLength = snprintf(header, sizeof(header), "#%d @%lu: ", job, (unsigned long)xTaskGetTickCount());
+
+        if (entry->sink == CLI_JOB_SINK_LOG)
+        {
+            cliJobLog(header, (size_t)headerLength);
+        }
+
+        FreeRTOS_CLIInitContext(&cliJob.context, cliJob.arena, sizeof(cliJob.arena));
+        entry->running = true;
+        entry->start = configCOMMAND_INT_GET_TIME();
+    }
+
+    FreeRTOS_CLISetContext(&cliJob.context);
+    more = FreeRTOS_CLIProcessResolvedCommand(entry->command, entry->line, output, outputSize);
+    BaseType_t status = FreeRTOS_CLIGetStatus();
+    FreeRTOS_CLISetContext(outerContext);
+
+    /* The chunk may be binary records */
+    outerContext->xOutputLength = cliJob.context.xOutputLength;
+
+    if (entry->sink == CLI_JOB_SINK_LOG)
+    {
+        cliJobLog(output, FreeRTOS_CLIGetOutputLength(output));
+        output[0] = '\0';
+        outerContext->xOutputLength = 0U;
+    }
+
+    if (more == pdFALSE)
+    {
+        uint32_t elapsed = configCOMMAND_INT_GET_TIME() - entry->start;
+
+        entry->running = false;
+        entry->runs++;
+        entry->failures += (status != cliSTATUS_OK) ? 1U : 0U;
+        entry->totalTime += elapsed;
+        entry->maxTime = (elapsed > entry->maxTime) ? elapsed : entry->maxTime;
+
+        /* A job run once is done */
+        if (entry->period == 0)
+        {
+            entry->line[0] = '\0';
+        }
+    }
+
+    return more;
+}
+
+/**
+ * @brief Cancels the jobs whose output goes to the console.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return     none.
+ */
+void CliJobCancelConsole(void)
+{
+    for (uint8_t job = 0; job < CLI_JOB_COUNT; job++)
+    {
+        if ((cliJob.entries[job].line[0] != '\0') &&
+            (cliJob.entries[job].sink == CLI_JOB_SINK_CONSOLE))
+        {
+            cliJobCancel(job);
+        }
+    }
+}
+
+/**
+ * @brief Registers the "at", "every" and "jobs" commands with FreeRTOS CLI.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return int16_t - 0 on success, negative value on error.
+ */
+int16_t CliJobCmdInit(void)
+{
+    int16_t status = 0;
+
+    cliJob.timer = xTimerCreate("CLI_Jobs", 1, pdFALSE, NULL, cliJobTimerCb);
+    if (cliJob.timer == NULL)
+    {
+        return -1;
+    }
+
+    for (size_t ind = 0; ind < (sizeof(cliJobDefinitions) / sizeof(cliJobDefinitions[0])); ind++)
+    {
+        if (FreeRTOS_CLIRegisterCommand(&cliJobDefinitions[ind]) != pdPASS)
+        {
+            status = -1;
+        }
+    }
+
+    return status;
+}
+
+//=====================================================================[ PRIVATE FUNCTIONS ]============================================================================================== //
+
+/**
+ * @brief Command callback function for the "at" command.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the delay, the optional sink and the command;
+ * \return     pdFALSE (indicates that the output has been fully written).
+ */
+static BaseType_t cliJobAtCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString)
+{
+    return cliJobSchedule(pcWriteBuffer, xWriteBufferLen, pcCommandString, false);
+}
+
+/**
+ * @brief Command callback function for the "every" command.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the period, the optional sink and the command;
+ * \return     pdFALSE (indicates that the output has been fully written).
+ */
+static BaseType_t cliJobEveryCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString)
+{
+    return cliJobSchedule(pcWriteBuffer, xWriteBufferLen, pcCommandString, true);
+}
+
+/**
+ * @brief Command callback function for the "jobs" command.
+ *
+ * "jobs log" empties the log as it reads it out, one buffer per call.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the optional subcommand;
+ * \return     pdTRUE if more output follows, otherwise pdFALSE.
+ */
+static BaseType_t cliJobsCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString)
+{
+    BaseType_t subLength = 0;
+    BaseType_t jobLength = 0;
+    const char *sub = FreeRTOS_CLIGetParameter(pcCommandString, 1, &subLength);
+    const char *jobParam = FreeRTOS_CLIGetParameter(pcCommandString, 2, &jobLength);
+
+    if ((pcWriteBuffer == NULL) ||
+        (xWriteBufferLen == 0))
+    {
+        return pdFALSE;
+    }
+
+    if (sub == NULL)
+    {
+        return cliJobList(pcWriteBuffer, xWriteBufferLen);
+    }
+
+    if ((subLength == 3) && (strncmp(sub, "log", 3) == 0) && (jobParam == NULL))
+    {
+        size_t length = xWriteBufferLen - 1U;
+
+        if (length > cliJob.logLength)
+        {
+            length = cliJob.logLength;
+        }
+
+        for (size_t ind = 0; ind < length; ind++)
+        {
+            pcWriteBuffer[ind] = cliJob.log[(cliJob.logHead + ind) % CLI_JOB_LOG_SIZE];
+        }
+        pcWriteBuffer[length] = '\0';
+
+        cliJob.logHead = (cliJob.logHead + length) % CLI_JOB_LOG_SIZE;
+        cliJob.logLength -= length;
+
+        return (cliJob.logLength > 0) ? pdTRUE : pdFALSE;
+    }
+
+    if ((subLength == 6) && (strncmp(sub, "cancel", 6) == 0) && (jobParam != NULL))
+    {
+        char *end = NULL;
+        unsigned long job = strtoul(jobParam, &end, 10);
+
+        if ((end != (jobParam + jobLength)) ||
+            (job >= CLI_JOB_COUNT) ||
+            (cliJob.entries[job].line[0] == '\0'))
+        {
+            FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_NOT_FOUND, "No such job\r\n");
+            FreeRTOS_CLISetStatus(cliSTATUS_NOT_FOUND);
+            return pdFALSE;
+        }
+
+        cliJobCancel((uint8_t)job);
+
+        snprintf(pcWriteBuffer, xWriteBufferLen, "OK\r\n");
+        return pdFALSE;
+    }
+
+    FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_INVALID_ARGUMENT, cliJobDefinitions[2].pcHelpString);
+    FreeRTOS_CLISetStatus(cliSTATUS_FAILED);
+
+    return pdFALSE;
+}
+
+/**
+ * @brief Schedules a job.
+ *
+ * The command is resolved and its parameters counted here, so a job that is
+ * accepted runs its command without looking it up.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string of "at" or "every";
+ * \param[in]  periodic        - The job runs every delay rather than once;
+ * \return     pdFALSE (indicates that the output has been fully written).
+ */
+static BaseType_t cliJobSchedule(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString, bool periodic)
+{
+    const CLI_Command_Definition_t *definition = &cliJobDefinitions[periodic ? 1 : 0];
+    BaseType_t delayLength = 0;
+    BaseType_t bodyLength = 0;
+    BaseType_t nextLength = 0;
+    const char *delayParam = FreeRTOS_CLIGetParameter(pcCommandString, 1, &delayLength);
+    const char *body = FreeRTOS_CLIGetParameter(pcCommandString, 2, &bodyLength);
+    uint8_t sink = CLI_JOB_SINK_LOG;
+    uint32_t ms = 0;
+    int8_t parameters = -1;
+    bool inWord = false;
+    uint8_t job = 0;
+
+    if ((pcWriteBuffer == NULL) ||
+        (xWriteBufferLen == 0))
+    {
+        return pdFALSE;
+    }
+
+    if ((delayParam == NULL) ||
+        (body == NULL))
+    {
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_PARAMETER_COUNT, definition->pcHelpString);
+        FreeRTOS_CLISetStatus(cliSTATUS_BAD_PARAMETERS);
+        return pdFALSE;
+    }
+
+    /* The sink is only a sink if a command follows it */
+    const char *next = FreeRTOS_CLIGetParameter(pcCommandString, 3, &nextLength);
+
+    if ((next != NULL) &&
+        (((bodyLength == 3) && (strncmp(body, "log", 3) == 0)) ||
+         ((bodyLength == 7) && (strncmp(body, "console", 7) == 0))))
+    {
+        sink = (bodyLength == 3) ? CLI_JOB_SINK_LOG : CLI_JOB_SINK_CONSOLE;
+        body = next;
+    }
+
+    if (!cliJobParseDelay(delayParam, delayLength, &ms) ||
+        (strlen(body) > CLI_JOB_MAX_LENGTH))
+    {
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_INVALID_ARGUMENT, definition->pcHelpString);
+        FreeRTOS_CLISetStatus(cliSTATUS_FAILED);
+        return pdFALSE;
+    }
+
+    while ((job < CLI_JOB_COUNT) &&
+           (cliJob.entries[job].line[0] != '\0'))
+    {
+        job++;
+    }
+
+    if (job == CLI_JOB_COUNT)
+    {
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_FULL, "No free job\r\n");
+        FreeRTOS_CLISetStatus(cliSTATUS_FAILED);
+        return pdFALSE;
+    }
+
+    CLI_Definition_List_Item_t *command = FreeRTOS_CLIResolveCommand(body, pcWriteBuffer, xWriteBufferLen);
+
+    if (command == NULL)
+    {
+        /* A command group that failed to load has written its own message */
+        if (FreeRTOS_CLIGetOutputLength(pcWriteBuffer) == 0)
+        {
+            FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_UNKNOWN_COMMAND, NULL);
+        }
+        FreeRTOS_CLISetStatus(cliSTATUS_NOT_FOUND);
+        return pdFALSE;
+    }
+
+    /* The job runs its command without counting its parameters */
+    for (const char *character = body; *character != '\0'; character++)
+    {
+        if (*character == ' ')
+        {
+            inWord = false;
+        }
+        else if (!inWord)
+        {
+            inWord = true;
+            parameters++;
+        }
+    }
+
+    if ((command->pxCommandLineDefinition->cExpectedNumberOfParameters >= 0) &&
+        (parameters != command->pxCommandLineDefinition->cExpectedNumberOfParameters))
+    {
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_PARAMETER_COUNT, NULL);
+        FreeRTOS_CLISetStatus(cliSTATUS_BAD_PARAMETERS);
+        return pdFALSE;
+    }
+
+    CliJobEntry_s *entry = &cliJob.entries[job];
+    /* pdMS_TO_TICKS() multiplies in TickType_t, which overflows for a day */
+    TickType_t ticks = (TickType_t)(((uint64_t)ms * configTICK_RATE_HZ) / 1000U);
+
+    memset(entry, 0, sizeof(*entry));
+    strcpy(entry->line, body);
+    entry->command = command;
+    entry->periodMs = ms;
+    entry->period = periodic ? ((ticks > 0) ? ticks : 1) : 0;
+    entry->due = xTaskGetTickCount() + ((ticks > 0) ? ticks : 1);
+    entry->sink = sink;
+    entry->heapIndex = CLI_JOB_NOT_QUEUED;
+
+    cliJobHeapPush(job);
+    cliJobArm();
+
+    snprintf(pcWriteBuffer, xWriteBufferLen, "job %u\r\n", (unsigned)job);
+
+    return pdFALSE;
+}
+
+/**
+ * @brief Lists the jobs, one record per job.
+ *
+ * Times until due and periods are in milliseconds, run times in
+ * configCOMMAND_INT_GET_TIME() units.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \return     pdTRUE if more output follows, otherwise pdFALSE.
+ */
+static BaseType_t cliJobList(char *pcWriteBuffer, size_t xWriteBufferLen)
+{
+    CLI_Command_Context_t *context = FreeRTOS_CLIGetContext();
+    TickType_t now = xTaskGetTickCount();
+    bool firstChunk = (context->uxIndex == 0);
+    bool found = false;
+    CLI_Record_t record;
+
+    FreeRTOS_CLIRecordInit(&record, pcWriteBuffer, xWriteBufferLen);
+
+    for (; context->uxIndex < CLI_JOB_COUNT; context->uxIndex++)
+    {
+        const CliJobEntry_s *entry = &cliJob.entries[context->uxIndex];
+        int32_t dueIn = (int32_t)(entry->due - now);
+
+        if (entry->line[0] == '\0')
+        {
+            continue;
+        }
+
+        FreeRTOS_CLIRecordBegin(&record);
+        FreeRTOS_CLIRecordUnsigned(&record, "job", (uint32_t)context->uxIndex);
+        FreeRTOS_CLIRecordString(&record, "kind", (entry->period != 0) ? "every" : "at");
+        FreeRTOS_CLIRecordUnsigned(&record, "ms", entry->periodMs);
+        FreeRTOS_CLIRecordUnsigned(&record, "due", (dueIn > 0) ? ((uint32_t)dueIn * portTICK_PERIOD_MS) : 0U);
+        FreeRTOS_CLIRecordString(&record, "sink", (entry->sink == CLI_JOB_SINK_CONSOLE) ? "console" : "log");
+        FreeRTOS_CLIRecordUnsigned(&record, "runs", entry->runs);
+        FreeRTOS_CLIRecordUnsigned(&record, "failed", entry->failures);
+        FreeRTOS_CLIRecordUnsigned(&record, "avg", (entry->runs > 0) ? (entry->totalTime / entry->runs) : 0U);
+        FreeRTOS_CLIRecordUnsigned(&record, "max", entry->maxTime);
+        FreeRTOS_CLIRecordString(&record, "command", entry->line);
+
+        if ((FreeRTOS_CLIRecordEnd(&record) != pdPASS) &&
+            (FreeRTOS_CLIRecordLength(&record) != 0))
+        {
+            /* The record does not fit, send it with the next chunk */
+            return pdTRUE;
+        }
+
+        found = true;
+    }
+
+    if (firstChunk &&
+        !found &&
+        (FreeRTOS_CLIGetFormat() == cliFORMAT_TEXT))
+    {
+        snprintf(pcWriteBuffer, xWriteBufferLen, "No jobs\r\n");
+    }
+
+    return pdFALSE;
+}
+
+/**
+ * @brief Parses a delay, in seconds or in milliseconds with the suffix "ms".
+ *
+ * \param[in]  text   - Delay parameter;
+ * \param[in]  length - Length of the parameter;
+ * \param[out] ms     - Delay in milliseconds;
+ * \return     bool - true if the parameter is a valid delay.
+ */
+static bool cliJobParseDelay(const char *text, BaseType_t length, uint32_t *ms)
+{
+    char *end = NULL;
+    unsigned long value = 0;
+
+    if ((*text < '0') || (*text > '9'))
+    {
+        return false;
+    }
+
+    value = strtoul(text, &end, 10);
+
+    if (end == (text + length))
+    {
+        if (value > CLI_JOB_MAX_SECONDS)
+        {
+            return false;
+        }
+        value *= CLI_JOB_MS_PER_SECOND;
+    }
+    else if ((end != (text + length - 2)) ||
+             (strncmp(end, "ms", 2) != 0) ||
+             (value > (CLI_JOB_MAX_SECONDS * CLI_JOB_MS_PER_SECOND)))
+    {
+        return false;
+    }
+
+    if (value == 0)
+    {
+        return false;
+    }
+
+    *ms = (uint32_t)value;
+
+    return true;
+}
+
+/**
+ * @brief Appends text to the job log, dropping its oldest bytes if it is full.
+ *
+ * \param[in]  text   - Text to append;
+ * \param[in]  length - Length of the text;
+ * \return     none.
+ */
+static void cliJobLog(const char *text, size_t length)
+{
+    for (size_t ind = 0; ind < length; ind++)
+    {
+        cliJob.log[(cliJob.logHead + cliJob.logLength) % CLI_JOB_LOG_SIZE] = text[ind];
+
+        if (cliJob.logLength < CLI_JOB_LOG_SIZE)
+        {
+            cliJob.logLength++;
+        }
+        else
+        {
+            cliJob.logHead = (cliJob.logHead + 1U) % CLI_JOB_LOG_SIZE;
+        }
+    }
+}
+
+/**
+ * @brief Returns true if job a is due before job b.
+ *
+ * \param[in]  a - Number of a job;
+ * \param[in]  b - Number of a job;
+ * \return     bool - true if a is due first.
+ */
+static bool cliJobBefore(uint8_t a, uint8_t b)
+{
+    return (int32_t)(cliJob.entries[a].due - cliJob.entries[b].due) < 0;
+}
+
+/**
+ * @brief Stores a job at a position of the heap.
+ *
+ * \param[in]  position - Position in the heap;
+ * \param[in]  job      - Number of the job;
+ * \return     none.
+ */
+static void cliJobHeapSet(uint8_t position, uint8_t job)
+{
+    cliJob.heap[position] = job;
+    cliJob.entries[job].heapIndex = position;
+}
+
+/**
+ * @brief Moves the job at a position of the heap up or down to its place.
+ *
+ * \param[in]  position - Position of the job in the heap;
+ * \return     none.
+ */
+static void cliJobHeapFix(uint8_t position)
+{
+    uint8_t job = cliJob.heap[position];
+
+    /* Up, while due before the parent */
+    while ((position > 0) &&
+           cliJobBefore(job, cliJob.heap[(position - 1U) / 2U]))
+    {
+        uint8_t parent = (uint8_t)((position - 1U) / 2U);
+
+        cliJobHeapSet(position, cliJob.heap[parent]);
+        position = parent;
+    }
+
+    /* Down, while a child is due first */
+    while (1)
+    {
+        uint8_t child = (uint8_t)((2U * position) + 1U);
+
+        if (child >= cliJob.heapCount)
+        {
+            break;
+        }
+
+        if (((child + 1U) < cliJob.heapCount) &&
+            cliJobBefore(cliJob.heap[child + 1U], cliJob.heap[child]))
+        {
+            child++;
+        }
+
+        if (!cliJobBefore(cliJob.heap[child], job))
+        {
+            break;
+        }
+
+        cliJobHeapSet(position, cliJob.heap[child]);
+        position = child;
+    }
+
+    cliJobHeapSet(position, job);
+}
+
+/**
+ * @brief Adds a job to the heap.
+ *
+ * \param[in]  job - Number of the job;
+ * \return     none.
+ */
+static void cliJobHeapPush(uint8_t job)
+{
+    cliJobHeapSet(cliJob.heapCount, job);
+    cliJob.heapCount++;
+    cliJobHeapFix(cliJob.heapCount - 1U);
+}
+
+/**
+ * @brief Removes a job from the heap.
+ *
+ * The last job of the heap takes its place and is moved to where it belongs.
+ *
+ * \param[in]  job - Number of a job in the heap;
+ * \return     none.
+ */
+static void cliJobHeapRemove(uint8_t job)
+{
+    uint8_t position = cliJob.entries[job].heapIndex;
+
+    cliJob.heapCount--;
+    cliJob.entries[job].heapIndex = CLI_JOB_NOT_QUEUED;
+
+    if (position < cliJob.heapCount)
+    {
+        cliJobHeapSet(position, cliJob.heap[cliJob.heapCount]);
+        cliJobHeapFix(position);
+    }
+}
+
+/**
+ * @brief Cancels a scheduled job.
+ *
+ * A job cancelled while it runs finishes its current chunk, CliJobProcess()
+ * then finds it gone.
+ *
+ * \param[in]  job - Number of a scheduled job;
+ * \return     none.
+ */
+static void cliJobCancel(uint8_t job)
+{
+    if (cliJob.entries[job].heapIndex != CLI_JOB_NOT_QUEUED)
+    {
+        cliJobHeapRemove(job);
+        cliJobArm();
+    }
+
+    cliJob.entries[job].line[0] = '\0';
+}
+
+/**
+ * @brief Arms the timer for the earliest due job, or stops it if no job waits.
+ *
+ * \param[in]  none;
+ * \return     none.
+ */
+static void cliJobArm(void)
+{
+    if (cliJob.heapCount == 0)
+    {
+        xTimerStop(cliJob.timer, 0);
+        return;
+    }
+
+    int32_t delay = (int32_t)(cliJob.entries[cliJob.heap[0]].due - xTaskGetTickCount());
+
+    /* Changing the period also starts the timer */
+    xTimerChangePeriod(cliJob.timer, (delay > 0) ? (TickType_t)delay : 1U, 0);
+}
+
+/**
+ * @brief Timer callback, wakes the task that runs the jobs.
+ *
+ * Runs in the timer service task, which must not run commands itself. A
+ * wakeup that could not be delivered is retried one tick later, as nothing
+ * else would make the CLI task take the due jobs.
+ *
+ * \param[in]  timer - Handle of the job timer;
+ * \return     none.
+ */
+static void cliJobTimerCb(TimerHandle_t timer)
+{
+    if ((cliJob.wakeup != NULL) && (cliJob.wakeup() != pdPASS))
+    {
+        xTimerChangePeriod(timer, 1U, 0);
+    }
+}
+
+#endif /* CLI_JOB_COUNT */
@@ -0,0 +1,139 @@
+/**
+ * @file cli_job.h
+ * @brief Commands executed later or periodically by the device itself.
+ *
+ * @details
+ * This file declares the "at", "every" and "jobs" commands, which let the
+ * device run health checks on its own instead of a host sending them over
+ * the wire:
+ *
+ *   at 30 selftest                   runs "selftest" once, in 30 seconds
+ *   every 10 console adc read 3      runs "adc read 3" every 10 seconds
+ *   every 500ms hello                runs "hello" every 500 milliseconds
+ *
+ * The command of a job is looked up and its parameters counted when the job
+ * is scheduled. The jobs wait in a heap ordered by their due time behind a
+ * single one-shot software timer armed for the earliest one, so scheduling,
+ * cancelling and running a job costs O(log n) in the number of jobs. The
+ * timer only wakes the CLI task, which hands the due jobs to a command worker
+ * on that wakeup or once the line being typed is complete, never in between
+ * its characters, as the command interpreter runs one command at a time.
+ *
+ * The output of a job goes to the job log, a ring in RAM read out and emptied
+ * with "jobs log", or with "console" to the console while a session is logged
+ * in; console jobs are cancelled when the session logs out. "jobs" lists the jobs with the number of runs and failures and their
+ * run times, in configCOMMAND_INT_GET_TIME() units.
+ *
+ * A periodic job keeps its rate; a run that comes too late to keep it is not
+ * made up for, the job is rescheduled one period after it actually ran.
+ *
+ * @date Created on 17.10.2026
+ * @author Yauheni Bialkou
+ */
+
+#ifndef CLI_JOB_H
+#define CLI_JOB_H
+
+//================================================================[INCLUDE]================================================================================================================//
+
+#include "FreeRTOS.h"     // FreeRTOS kernel headers
+#include "timers.h"       // FreeRTOS software timer the jobs wait on
+#include "FreeRTOS_CLI.h" // FreeRTOS CLI API
+
+//===========================================================[MACRO DEFINITIONS]===========================================================================================================//
+
+#define CLI_JOB_COUNT 8                  // Maximum number of scheduled jobs, 0 to disable the job commands
+#define CLI_JOB_MAX_LENGTH 64            // Maximum length of the command of a job, in characters
+#define CLI_JOB_MAX_SECONDS 86400        // Longest delay or period of a job, in seconds
+#define CLI_JOB_ARENA_SIZE 128           // Scratch arena of the command of a job, in bytes
+#define CLI_JOB_LOG_SIZE 1024            // Size of the job log, in bytes
+
+//========================================================[DATA TYPES DEFINITIONS]=========================================================================================================//
+
+/**
+ * @brief Enumeration for the destinations of the output of a job.
+ */
+typedef enum
+{
+    CLI_JOB_SINK_LOG = 0,    // The job log in RAM
+    CLI_JOB_SINK_CONSOLE = 1 // The console, while a session is logged in
+
+} CliJobSink_e;
+
+//===========================================================[PUBLIC INTERFACE]============================================================================================================//
+
+#if (CLI_JOB_COUNT > 0)
+
+/**
+ * @brief Sets the function called from the timer service task when a job is due.
+ *
+ * The function must wake the task that calls CliJobTake() and return pdPASS,
+ * or pdFAIL if it could not, in which case the job timer is re-armed to try
+ * again one tick later.
+ *
+ * \param[in]  wakeup - Function waking the CLI task;
+ * \param[out] none;
+ * \return none.
+ */
+void CliJobSetWakeup(BaseType_t (*wakeup)(void));
+
+/**
+ * @brief Takes the earliest due job and reschedules it if it is periodic.
+ *
+ * Must be called from the task that runs commands, between two commands.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return int16_t - Number of the job to run with CliJobProcess(), -1 if no job is due.
+ */
+int16_t CliJobTake(void);
+
+/**
+ * @brief Returns the command a job runs.
+ *
+ * \param[in]  job - Number of the job;
+ * \param[out] none;
+ * \return CLI_Definition_List_Item_t * - List item of the command, to select a worker for it.
+ */
+CLI_Definition_List_Item_t *CliJobCommand(int16_t job);
+
+/**
+ * @brief Runs the command of a job for one chunk of output.
+ *
+ * Called until it returns pdFALSE, like FreeRTOS_CLIProcessCommand(). The
+ * output of a job logged in RAM is moved to the log, leaving the output
+ * buffer empty; the output of a console job is left in it to be transmitted,
+ * its length given by FreeRTOS_CLIGetOutputLength() as it may be binary.
+ * The statistics of the job are updated after its last chunk.
+ *
+ * \param[in]  job        - Number of the job taken with CliJobTake();
+ * \param[out] output     - Buffer receiving the output of the command;
+ * \param[in]  outputSize - Size of the output buffer;
+ * \return BaseType_t - pdTRUE if more output follows, otherwise pdFALSE.
+ */
+BaseType_t CliJobProcess(int16_t job, char *output, size_t outputSize);
+
+/**
+ * @brief Cancels the jobs whose output goes to the console.
+ *
+ * Called when the session logs out, as their output belongs to it. Jobs
+ * logged in RAM keep running, they are the device's own health checks.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return none.
+ */
+void CliJobCancelConsole(void);
+
+/**
+ * @brief Registers the "at", "every" and "jobs" commands with FreeRTOS CLI.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return int16_t - 0 on success, negative value on error.
+ */
+int16_t CliJobCmdInit(void);
+
+#endif /* CLI_JOB_COUNT */
+
+#endif /* CLI_JOB_H */
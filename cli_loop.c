@@ -0,0 +1,534 @@
+/**
+ * @file cli_loop.c
+ * @brief Implementation of the "repeat" and "for" commands.
+ *
+ * @details
+ * On its first call a loop splits its command into words, marks the words
+ * that stand for the variable and resolves the command to its list item. Each
+ * later call writes the next command line from the words and runs it through
+ * FreeRTOS_CLIProcessResolvedCommand() in a context nested in the loop's own,
+ * with the rest of the loop's scratch arena, like a script does.
+ *
+ * Every call of the loop makes one call of the command, so a chunk of its
+ * output goes to the console before the next call and a long loop of silent
+ * runs still returns to the console between runs.
+ *
+ * @date Created on 17.10.2026
+ * @author Yauheni Bialkou
+ */
+
+//======================================================================[ INCLUDE ]======================================================================================================== //
+
+#include "cli_loop.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#if (CLI_LOOP_MAX_RUNS > 0)
+
+//======================================================================[ INTERNAL MACRO DEFENITIONS ]===================================================================================== //
+
+#define CLI_LOOP_ARENA_MARGIN 8U     // Arena bytes kept back for the alignment of the nested command's arena
+#define CLI_LOOP_VALUE_LENGTH 11U    // Longest decimal value of the variable, "-2147483648"
+#define CLI_LOOP_VARIABLE_CHAR '$'   // Marks the variable in the command, followed by its name
+
+//======================================================================[ INTERNAL DATA TYPES DEFINITIONS ]================================================================================ //
+
+/**
+ * @brief One word of the command of a loop.
+ */
+typedef struct
+{
+    uint16_t offset; // Offset of the word in the command
+    uint8_t length;  // Length of the word
+    bool variable;   // The word stands for the variable
+} CliLoopWord_s;
+
+/**
+ * @brief State of a loop, kept in its arena between calls.
+ */
+typedef struct
+{
+    CLI_Command_Context_t context;             // Context of the command being looped
+    CLI_Definition_List_Item_t *command;       // Command of the loop
+    const char *body;                          // Command of the loop, as entered
+    CliLoopWord_s words[CLI_LOOP_MAX_WORDS];   // Words of the command
+    uint8_t wordCount;                         // Number of words of the command
+    int32_t value;                             // Value of the variable for the current run
+    int32_t step;                              // Change of the variable from one run to the next
+    uint32_t remaining;                        // Runs left, including the current one
+    bool running;                              // The current run has more output to return
+    char line[];                               // Command line of the current run
+} CliLoop_s;
+
+//======================================================================[ INTERNAL FUNCTIONS AND OBJECTS DECLARATION ]===================================================================== //
+
+/**
+ * @brief Command callback function for the "repeat" command.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the number of runs and the command;
+ * \return     pdTRUE if more output follows, otherwise pdFALSE.
+ */
+static BaseType_t cliRepeatCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
+
+/**
+ * @brief Command callback function for the "for" command.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the variable, the range and the command;
+ * \return     pdTRUE if more output follows, otherwise pdFALSE.
+ */
+static BaseType_t cliForCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
+
+/**
+ * @brief Splits the command of a loop into words and resolves it.
+ *
+ * \param[out] pcWriteBuffer   - Buffer receiving the error message on failure;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  body            - Command of the loop;
+ * \param[in]  name            - Name of the variable, NULL if the loop has none;
+ * \param[in]  nameLength      - Length of the name;
+ * \param[in]  first           - Value of the variable for the first run;
+ * \param[in]  last            - Value of the variable for the last run;
+ * \return     CliLoop_s * - State of the loop, NULL on failure with the status set.
+ */
+static CliLoop_s *cliLoopStart(char *pcWriteBuffer, size_t xWriteBufferLen, const char *body, const char *name, size_t nameLength, int32_t first, int32_t last);
+
+/**
+ * @brief Makes one call of the command of a loop.
+ *
+ * \param[in,out] state           - State of the loop;
+ * \param[out]    pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]     xWriteBufferLen - Maximum buffer length;
+ * \return        pdTRUE if more output follows, otherwise pdFALSE.
+ */
+static BaseType_t cliLoopRun(CliLoop_s *state, char *pcWriteBuffer, size_t xWriteBufferLen);
+
+/**
+ * @brief Parses a decimal bound of a loop.
+ *
+ * A bound outside the range of int32_t is rejected.
+ *
+ * \param[in]  text  - Text of the bound;
+ * \param[out] end   - Receives the first character after the bound;
+ * \param[out] value - Receives the bound;
+ * \return     bool - true if the text starts with a valid bound.
+ */
+static bool cliLoopParseBound(const char *text, const char **end, int32_t *value);
+
+/**
+ * @brief Returns the distance between the bounds of a loop.
+ *
+ * \param[in]  first - First bound;
+ * \param[in]  last  - Last bound;
+ * \return     uint32_t - Number of runs of the loop minus one.
+ */
+static uint32_t cliLoopSpan(int32_t first, int32_t last);
+
+/**
+ * @brief Command definitions of the loop commands.
+ */
+static const CLI_Command_Definition_t cliLoopDefinitions[] =
+    {
+        {
+            .pcCommand = "repeat",
+            .pcHelpString = "repeat <n> <command> - runs a command n times \r\n",
+            .pxCommandInterpreter = cliRepeatCommand,
+            .cExpectedNumberOfParameters = -1,
+            .usStackDepth = 384, // The looped command runs nested on the same stack
+        },
+        {
+            .pcCommand = "for",
+            .pcHelpString = "for <var> <a>..<b>[:] <command> - runs a command with each $var replaced by a to b \r\n",
+            .pxCommandInterpreter = cliForCommand,
+            .cExpectedNumberOfParameters = -1,
+            .usStackDepth = 384, // The looped command runs nested on the same stack
+        }};
+
+//=======================================================================[PUBLIC INTERFACE FUNCTIONS]===================================================================================== //
+
+/**
+ * @brief Registers the "repeat" and "for" commands with FreeRTOS CLI.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return int16_t - 0 on success, negative value on error.
+ */
+int16_t CliLoopCmdInit(void)
+{
+    int16_t status = 0;
+
+    for (size_t ind = 0; ind < (sizeof(cliLoopDefinitions) / sizeof(cliLoopDefinitions[0])); ind++)
+    {
+        if (FreeRTOS_CLIRegisterCommand(&cliLoopDefinitions[ind]) != pdPASS)
+        {
+            status = -1;
+        }
+    }
+
+    return status;
+}
+
+//=====================================================================[ PRIVATE FUNCTIONS ]============================================================================================== //
+
+/**
+ * @brief Command callback function for the "repeat" command.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the number of runs and the command;
+ * \return     pdTRUE if more output follows, otherwise pdFALSE.
+ */
+static BaseType_t cliRepeatCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString)
+{
+    CliLoop_s *state = (CliLoop_s *)FreeRTOS_CLIGetContext()->pvCursor;
+    BaseType_t runsLength = 0;
+    BaseType_t bodyLength = 0;
+    const char *end = NULL;
+    int32_t runs = 0;
+
+    if ((pcWriteBuffer == NULL) ||
+        (xWriteBufferLen == 0))
+    {
+        return pdFALSE;
+    }
+
+    if (state == NULL)
+    {
+        const char *runsParam = FreeRTOS_CLIGetParameter(pcCommandString, 1, &runsLength);
+        const char *body = FreeRTOS_CLIGetParameter(pcCommandString, 2, &bodyLength);
+
+        if ((runsParam == NULL) ||
+            (body == NULL))
+        {
+            FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_PARAMETER_COUNT, cliLoopDefinitions[0].pcHelpString);
+            FreeRTOS_CLISetStatus(cliSTATUS_BAD_PARAMETERS);
+            return pdFALSE;
+        }
+
+        if (!cliLoopParseBound(runsParam, &end, &runs) ||
+            (end != (runsParam + runsLength)) ||
+            (runs < 1) ||
+            (runs > CLI_LOOP_MAX_RUNS))
+        {
+            FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_INVALID_ARGUMENT, cliLoopDefinitions[0].pcHelpString);
+            FreeRTOS_CLISetStatus(cliSTATUS_FAILED);
+            return pdFALSE;
+        }
+
+        state = cliLoopStart(pcWriteBuffer, xWriteBufferLen, body, NULL, 0, 1, runs);
+        if (state == NULL)
+        {
+            return pdFALSE;
+        }
+    }
+
+    return cliLoopRun(state, pcWriteBuffer, xWriteBufferLen);
+}
+
+/**
+ * @brief Command callback function for the "for" command.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the variable, the range and the command;
+ * \return     pdTRUE if more output follows, otherwise pdFALSE.
+ */
+static BaseType_t cliForCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString)
+{
+    CliLoop_s *state = (CliLoop_s *)FreeRTOS_CLIGetContext()->pvCursor;
+    BaseType_t nameLength = 0;
+    BaseType_t rangeLength = 0;
+    BaseType_t bodyLength = 0;
+    const char *end = NULL;
+    int32_t first = 0;
+    int32_t last = 0;
+
+    if ((pcWriteBuffer == NULL) ||
+        (xWriteBufferLen == 0))
+    {
+        return pdFALSE;
+    }
+
+    if (state == NULL)
+    {
+        const char *name = FreeRTOS_CLIGetParameter(pcCommandString, 1, &nameLength);
+        const char *range = FreeRTOS_CLIGetParameter(pcCommandString, 2, &rangeLength);
+        const char *body = FreeRTOS_CLIGetParameter(pcCommandString, 3, &bodyLength);
+
+        if ((name == NULL) ||
+            (range == NULL) ||
+            (body == NULL))
+        {
+            FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_PARAMETER_COUNT, cliLoopDefinitions[1].pcHelpString);
+            FreeRTOS_CLISetStatus(cliSTATUS_BAD_PARAMETERS);
+            return pdFALSE;
+        }
+
+        /* The range is "<a>..<b>", optionally followed by ':' */
+        bool valid = (nameLength <= CLI_LOOP_MAX_NAME_LENGTH) &&
+                     cliLoopParseBound(range, &end, &first) &&
+                     (strncmp(end, "..", 2) == 0) &&
+                     cliLoopParseBound(end + 2, &end, &last);
+
+        if (valid && (*end == ':'))
+        {
+            end++;
+        }
+
+        if (!valid ||
+            (end != (range + rangeLength)) ||
+            (cliLoopSpan(first, last) >= CLI_LOOP_MAX_RUNS))
+        {
+            FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_INVALID_ARGUMENT, cliLoopDefinitions[1].pcHelpString);
+            FreeRTOS_CLISetStatus(cliSTATUS_FAILED);
+            return pdFALSE;
+        }
+
+        state = cliLoopStart(pcWriteBuffer, xWriteBufferLen, body, name, (size_t)nameLength, first, last);
+        if (state == NULL)
+        {
+            return pdFALSE;
+        }
+    }
+
+    return cliLoopRun(state, pcWriteBuffer, xWriteBufferLen);
+}
+
+/**
+ * @brief Splits the command of a loop into words and resolves it.
+ *
+ * The state, the command line and the nested context's arena are all taken
+ * from the loop's arena, and the state is kept in the loop's context.
+ *
+ * \param[out] pcWriteBuffer   - Buffer receiving the error message on failure;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  body            - Command of the loop;
+ * \param[in]  name            - Name of the variable, NULL if the loop has none;
+ * \param[in]  nameLength      - Length of the name;
+ * \param[in]  first           - Value of the variable for the first run;
+ * \param[in]  last            - Value of the variable for the last run;
+ * \return     CliLoop_s * - State of the loop, NULL on failure with the status set.
+ */
+static CliLoop_s *cliLoopStart(char *pcWriteBuffer, size_t xWriteBufferLen, const char *body, const char *name, size_t nameLength, int32_t first, int32_t last)
+{
+    CLI_Command_Context_t *outerContext = FreeRTOS_CLIGetContext();
+    CliLoopWord_s words[CLI_LOOP_MAX_WORDS] = {0};
+    uint8_t wordCount = 0;
+    size_t lineSize = 1;
+    const char *text = body;
+
+    while (*text != '\0')
+    {
+        size_t wordLength = strcspn(text, " ");
+
+        if (wordLength == 0)
+        {
+            text++;
+            continue;
+        }
+
+        if ((wordCount == CLI_LOOP_MAX_WORDS) ||
+            (wordLength > UINT8_MAX))
+        {
+            FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_INVALID_ARGUMENT, "Loop command is too long\r\n");
+            FreeRTOS_CLISetStatus(cliSTATUS_FAILED);
+            return NULL;
+        }
+
+        CliLoopWord_s *word = &words[wordCount++];
+
+        word->offset = (uint16_t)(text - body);
+        word->length = (uint8_t)wordLength;
+        word->variable = (name != NULL) &&
+                         (wordLength == (nameLength + 1U)) &&
+                         (text[0] == CLI_LOOP_VARIABLE_CHAR) &&
+                         (strncmp(&text[1], name, nameLength) == 0);
+
+        lineSize += (word->variable ? CLI_LOOP_VALUE_LENGTH : wordLength) + 1U;
+        text += wordLength;
+    }
+
+    if (words[0].variable)
+    {
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_INVALID_ARGUMENT, "Loop command cannot be the variable\r\n");
+        FreeRTOS_CLISetStatus(cliSTATUS_FAILED);
+        return NULL;
+    }
+
+    /* The only lookup of the loop */
+    CLI_Definition_List_Item_t *command = FreeRTOS_CLIResolveCommand(body, pcWriteBuffer, xWriteBufferLen);
+
+    if (command == NULL)
+    {
+        /* A command group that failed to load has written its own message */
+        if (FreeRTOS_CLIGetOutputLength(pcWriteBuffer) == 0)
+        {
+            FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_UNKNOWN_COMMAND, NULL);
+        }
+        FreeRTOS_CLISetStatus(cliSTATUS_NOT_FOUND);
+        return NULL;
+    }
+
+    int8_t expected = command->pxCommandLineDefinition->cExpectedNumberOfParameters;
+
+    if ((expected >= 0) &&
+        ((wordCount - 1) != expected))
+    {
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_PARAMETER_COUNT, NULL);
+        FreeRTOS_CLISetStatus(cliSTATUS_BAD_PARAMETERS);
+        return NULL;
+    }
+
+    CliLoop_s *state = FreeRTOS_CLIArenaAlloc(sizeof(CliLoop_s) + lineSize);
+
+    if (state == NULL)
+    {
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_FULL, NULL);
+        FreeRTOS_CLISetStatus(cliSTATUS_FAILED);
+        return NULL;
+    }
+
+    memcpy(state->words, words, sizeof(words));
+    state->wordCount = wordCount;
+    state->command = command;
+    state->body = body;
+    state->value = first;
+    state->step = (last >= first) ? 1 : -1;
+    state->remaining = cliLoopSpan(first, last) + 1U;
+    state->running = false;
+    outerContext->pvCursor = state;
+
+    /* The looped command gets the rest of the arena and the session's settings */
+    size_t arenaSize = outerContext->xArenaSize - outerContext->xArenaUsed;
+    void *arena = (arenaSize > CLI_LOOP_ARENA_MARGIN) ? FreeRTOS_CLIArenaAlloc(arenaSize - CLI_LOOP_ARENA_MARGIN) : NULL;
+
+    FreeRTOS_CLIInitContext(&state->context, arena, (arena != NULL) ? (arenaSize - CLI_LOOP_ARENA_MARGIN) : 0U);
+    state->context.ucVerbosity = outerContext->ucVerbosity;
+    state->context.ucFormat = outerContext->ucFormat;
+    state->context.ucNesting = outerContext->ucNesting;
+
+    return state;
+}
+
+/**
+ * @brief Makes one call of the command of a loop.
+ *
+ * The command line of a run is written when the run starts, the value of the
+ * variable being the only part that changes from one run to the next.
+ *
+ * \param[in,out] state           - State of the loop;
+ * \param[out]    pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]     xWriteBufferLen - Maximum buffer length;
+ * \return        pdTRUE if more output follows, otherwise pdFALSE.
+ */
+static BaseType_t cliLoopRun(CliLoop_s *state, char *pcWriteBuffer, size_t xWriteBufferLen)
+{
+    CLI_Command_Context_t *outerContext = FreeRTOS_CLIGetContext();
+
+    if (!state->running)
+    {
+        size_t length = 0;
+
+        for (uint8_t ind = 0; ind < state->wordCount; ind++)
+        {
+            const CliLoopWord_s *word = &state->words[ind];
+
+            if (ind != 0)
+            {
+                state->line[length++] = ' ';
+            }
+
+            if (word->variable)
+            {
+                length += (size_t)sprintf(&state->line[length], "%ld", (long)state->value);
+            }
+            else
+            {
+                memcpy(&state->line[length], &state->body[word->offset], word->length);
+                length += word->length;
+            }
+        }
+
+        state->line[length] = '\0';
+        state->running = true;
+    }
+
+    FreeRTOS_CLISetContext(&state->context);
+    BaseType_t more = FreeRTOS_CLIProcessResolvedCommand(state->command, state->line, pcWriteBuffer, xWriteBufferLen);
+    FreeRTOS_CLISetContext(outerContext);
+
+    /* The chunk may be binary records */
+    outerContext->xOutputLength = state->context.xOutputLength;
+
+    if (more != pdFALSE)
+    {
+        return pdTRUE;
+    }
+
+    state->running = false;
+    state->remaining--;
+
+    /* Stepping past the last bound could overflow if it is INT32_MAX or INT32_MIN */
+    if (state->remaining > 0)
+    {
+        state->value += state->step;
+    }
+
+    /* Stop at the first run that fails, leaving its output */
+    if (state->context.xStatus != cliSTATUS_OK)
+    {
+        FreeRTOS_CLISetStatus(state->context.xStatus);
+        return pdFALSE;
+    }
+
+    return (state->remaining > 0) ? pdTRUE : pdFALSE;
+}
+
+/**
+ * @brief Parses a decimal bound of a loop.
+ *
+ * A bound outside the range of int32_t is rejected.
+ *
+ * \param[in]  text  - Text of the bound;
+ * \param[out] end   - Receives the first character after the bound;
+ * \param[out] value - Receives the bound;
+ * \return     bool - true if the text starts with a valid bound.
+ */
+static bool cliLoopParseBound(const char *text, const char **end, int32_t *value)
+{
+    char *parsed = NULL;
+    long bound = 0;
+
+    /* strtol() clamps a bound out of the range of long, only errno tells */
+    errno = 0;
+    bound = strtol(text, &parsed, 10);
+
+    *end = parsed;
+    *value = (int32_t)bound;
+
+    return (parsed != text) &&
+           (errno != ERANGE) &&
+           (bound >= INT32_MIN) &&
+           (bound <= INT32_MAX);
+}
+
+/**
+ * @brief Returns the distance between the bounds of a loop.
+ *
+ * \param[in]  first - First bound;
+ * \param[in]  last  - Last bound;
+ * \return     uint32_t - Number of runs of the loop minus one.
+ */
+static uint32_t cliLoopSpan(int32_t first, int32_t last)
+{
+    /* Computed modulo 2^32, so it cannot overflow */
+    return (last >= first) ? ((uint32_t)last - (uint32_t)first) : ((uint32_t)first - (uint32_t)last);
+}
+
+#endif /* CLI_LOOP_MAX_RUNS */
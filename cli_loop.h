@@ -0,0 +1,54 @@
+/**
+ * @file cli_loop.h
+ * @brief Loops of commands executed on the device.
+ *
+ * @details
+ * This file declares the "repeat" and "for" commands, which run a command
+ * several times in one invocation instead of one line per run from the host:
+ *
+ *   repeat 10 adc read 3             runs "adc read 3" 10 times
+ *   for ch 0..63 adc read $ch        runs "adc read 0" to "adc read 63"
+ *
+ * The range of "for" is inclusive and counts down if its first bound is the
+ * larger; a ':' may follow it. Every word "$<variable>" of the command is
+ * replaced by the value of the variable.
+ *
+ * The command is split into words and looked up once, before the first run;
+ * each run only writes the value of the variable into the command line. The
+ * output of all the runs is streamed back as the output of the loop. The loop
+ * stops at the first run that fails, with that run's status.
+ *
+ * @date Created on 17.10.2026
+ * @author Yauheni Bialkou
+ */
+
+#ifndef CLI_LOOP_H
+#define CLI_LOOP_H
+
+//================================================================[INCLUDE]================================================================================================================//
+
+#include "FreeRTOS.h"     // FreeRTOS kernel headers
+#include "FreeRTOS_CLI.h" // FreeRTOS CLI API
+
+//===========================================================[MACRO DEFINITIONS]===========================================================================================================//
+
+#define CLI_LOOP_MAX_RUNS 10000      // Largest number of runs of a loop, 0 to disable the loop commands
+#define CLI_LOOP_MAX_WORDS 16        // Maximum number of words of the command of a loop
+#define CLI_LOOP_MAX_NAME_LENGTH 8   // Maximum length of the variable of "for", in characters
+
+//===========================================================[PUBLIC INTERFACE]============================================================================================================//
+
+#if (CLI_LOOP_MAX_RUNS > 0)
+
+/**
+ * @brief Registers the "repeat" and "for" commands with FreeRTOS CLI.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return int16_t - 0 on success, negative value on error.
+ */
+int16_t CliLoopCmdInit(void);
+
+#endif /* CLI_LOOP_MAX_RUNS */
+
+#endif /* CLI_LOOP_H */
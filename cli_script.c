@@ -0,0 +1,1353 @@
+/**
+ * @file cli_script.c
+ * @brief Implementation of command scripts stored in flash.
+ *
+ * @details
+ * Each slot holds the script's lines back to back, every line terminated by
+ * '\n'. The first erased byte marks the end of the script, so lines are added
+ * with a flash append and a slot only needs erasing to start a new script.
+ *
+ * A compiled program is a header followed by fixed size instructions, the
+ * instructions that run a command followed by its null-terminated line. The
+ * program starts with one instruction per command naming it, so all of them
+ * are looked up before the first one runs, and ends with CLI_SCRIPT_OP_END.
+ * The header is written last: its magic number only appears once the program
+ * is complete.
+ *
+ * @date Created on 17.10.2026
+ * @author Yauheni Bialkou
+ */
+
+//======================================================================[ INCLUDE ]======================================================================================================== //
+
+#include "cli_script.h"
+#include "cli_loop.h"
+#include "task.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+//======================================================================[ INTERNAL MACRO DEFENITIONS ]===================================================================================== //
+
+#define CLI_SCRIPT_ERASED 0xFF                // Value of an erased flash byte
+#define CLI_SCRIPT_READ_CHUNK 32              // Bytes read at a time while searching for the end of a script
+#define CLI_SCRIPT_CODE_MAGIC 0x43535031UL    // Marks a complete compiled program
+#define CLI_SCRIPT_ERASED_MAGIC 0xFFFFFFFFUL  // Magic number of a program area that holds no program
+#define CLI_SCRIPT_REPEAT "repeat "           // Start of the lines compiled into a loop
+#define CLI_SCRIPT_ARENA_MARGIN 8U            // Arena bytes kept back for the alignment of the script's arena
+
+//======================================================================[ INTERNAL DATA TYPES DEFINITIONS ]================================================================================ //
+
+/**
+ * @brief Condition of a script line on the status of the last command that ran.
+ */
+typedef enum
+{
+    CLI_SCRIPT_IF_ANY = 0,            // The line always runs
+    CLI_SCRIPT_IF_OK,                 // '?': the line runs if the last command succeeded
+    CLI_SCRIPT_IF_FAILED              // '!': the line runs if the last command failed
+
+} CliScriptCondition_e;
+
+/**
+ * @brief Operations of a compiled program.
+ */
+typedef enum
+{
+    CLI_SCRIPT_OP_END = 0,            // End of the program
+    CLI_SCRIPT_OP_COMMAND,            // Looks up the command named by the text that follows
+    CLI_SCRIPT_OP_RUN,                // Runs the line that follows, a failure stops the program
+    CLI_SCRIPT_OP_TRY,                // Runs the line that follows, a failure only sets the status
+    CLI_SCRIPT_OP_JUMP_OK,            // Jumps if the last command succeeded
+    CLI_SCRIPT_OP_JUMP_FAILED,        // Jumps if the last command failed
+    CLI_SCRIPT_OP_COUNT,              // Loads the loop counter
+    CLI_SCRIPT_OP_LOOP                // Counts down and jumps while the counter is not zero
+
+} CliScriptOp_e;
+
+/**
+ * @brief Instruction of a compiled program.
+ */
+typedef struct
+{
+    uint8_t op;                       // CliScriptOp_e value
+    uint8_t command;                  // Index of the command in the program's command table
+    uint16_t operand;                 // Size of the text that follows, jump target or loop count
+    uint16_t line;                    // Script line the instruction was compiled from
+
+} CliScriptInstruction_s;
+
+/**
+ * @brief Header of a compiled program.
+ */
+typedef struct
+{
+    uint32_t magic;                   // CLI_SCRIPT_CODE_MAGIC
+    uint32_t scriptLength;            // Length of the script the program was compiled from
+    uint16_t lineCount;               // Number of lines of the script
+    uint16_t codeLength;              // Size of the instructions after the header
+
+} CliScriptCodeHeader_s;
+
+/**
+ * @brief Script line split into its conditions and its command.
+ */
+typedef struct
+{
+    uint8_t condition;                // CliScriptCondition_e value
+    bool tolerant;                    // '-': a failure of the command does not stop the script
+    uint16_t runs;                    // Number of runs of a compiled "repeat" line, 1 otherwise
+    const char *command;              // Command line to run
+
+} CliScriptLine_s;
+
+//======================================================================[ INTERNAL FUNCTIONS AND OBJECTS DECLARATION ]===================================================================== //
+
+static int32_t cliScriptLengths[CLI_SCRIPT_SLOT_COUNT] = {0};   // Cached length of each slot
+static bool cliScriptLengthKnown[CLI_SCRIPT_SLOT_COUNT] = {0};  // The cached length of the slot is valid
+
+/**
+ * @brief Command callback function for the "script" command.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the subcommand and its parameters;
+ * \return     pdTRUE if more output follows, otherwise pdFALSE.
+ */
+static BaseType_t cliScriptCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
+
+/**
+ * @brief Command callback function for the "exec" command.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the slot number;
+ * \return     pdFALSE (indicates that the output has been fully written).
+ */
+static BaseType_t cliScriptExecCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
+
+/**
+ * @brief Executes a script in a context nested in the current one.
+ *
+ * \param[in]  slot       - Script slot;
+ * \param[in]  compiled   - Execute the compiled program if it is up to date;
+ * \param[out] output     - Buffer receiving the output of the commands;
+ * \param[in]  outputSize - Size of the output buffer;
+ * \param[out] lineNumber - Number of lines executed, or the number of the line that failed;
+ * \return     int16_t - CLI_SCRIPT_OK on success, negative CliScriptStatus_e value on failure.
+ */
+static int16_t cliScriptExecute(uint8_t slot, bool compiled, char *output, size_t outputSize, uint16_t *lineNumber);
+
+/**
+ * @brief Executes the text of a script.
+ *
+ * \param[in]  slot       - Script slot;
+ * \param[in]  context    - Context the commands run in;
+ * \param[out] output     - Buffer receiving the output of the commands;
+ * \param[in]  outputSize - Size of the output buffer;
+ * \param[out] lineNumber - Number of lines executed, or the number of the line that failed;
+ * \return     int16_t - CLI_SCRIPT_OK on success, negative CliScriptStatus_e value on failure.
+ */
+static int16_t cliScriptRunText(uint8_t slot, CLI_Command_Context_t *context, char *output, size_t outputSize, uint16_t *lineNumber);
+
+/**
+ * @brief Executes the compiled program of a script.
+ *
+ * \param[in]  slot       - Script slot;
+ * \param[in]  context    - Context the commands run in;
+ * \param[out] output     - Buffer receiving the output of the commands;
+ * \param[in]  outputSize - Size of the output buffer;
+ * \param[out] lineNumber - Number of lines executed, or the number of the line that failed;
+ * \return     int16_t - CLI_SCRIPT_OK on success, CLI_SCRIPT_ERR_COMPILE if there is no up to date program
+ *                        or one of its commands is no longer registered, in which case no command has run,
+ *                        other negative CliScriptStatus_e value on failure.
+ */
+static int16_t cliScriptRunCode(uint8_t slot, CLI_Command_Context_t *context, char *output, size_t outputSize, uint16_t *lineNumber);
+
+/**
+ * @brief Runs one command line to completion in a nested context.
+ *
+ * \param[in]  context    - Context the command runs in;
+ * \param[in]  command    - Resolved command, NULL to look the command up;
+ * \param[in]  line       - Command line;
+ * \param[out] output     - Buffer receiving the output of the command, each chunk overwriting the previous one;
+ * \param[in]  outputSize - Size of the output buffer;
+ * \return     BaseType_t - Status of the command, cliSTATUS_OK on success.
+ */
+static BaseType_t cliScriptRunLine(CLI_Command_Context_t *context, CLI_Definition_List_Item_t *command, const char *line, char *output, size_t outputSize);
+
+/**
+ * @brief Splits a script line into its conditions and its command.
+ *
+ * \param[in]  text   - Script line, neither empty nor a comment;
+ * \param[out] parsed - Conditions and command of the line; runs is always 1;
+ * \return     none.
+ */
+static void cliScriptParseLine(const char *text, CliScriptLine_s *parsed);
+
+/**
+ * @brief Parses a script line for compilation and looks up its command.
+ *
+ * \param[in]  text    - Script line, neither empty nor a comment;
+ * \param[out] parsed  - Conditions, number of runs and command of the line;
+ * \param[out] command - Resolved command;
+ * \return     int16_t - CLI_SCRIPT_OK on success, CLI_SCRIPT_ERR_COMPILE if the line cannot be compiled.
+ */
+static int16_t cliScriptCompileLine(const char *text, CliScriptLine_s *parsed, CLI_Definition_List_Item_t **command);
+
+/**
+ * @brief Appends an instruction and the text that follows it to a compiled program.
+ *
+ * \param[in]     slot        - Script slot;
+ * \param[in,out] pc          - Offset of the instruction, advanced past it;
+ * \param[in]     instruction - Instruction; the operand of an instruction followed by text is set here;
+ * \param[in]     text        - Text following the instruction, NULL if none;
+ * \param[in]     textLength  - Length of the text, without the terminator;
+ * \return        int16_t - CLI_SCRIPT_OK on success, negative CliScriptStatus_e value on failure.
+ */
+static int16_t cliScriptEmit(uint8_t slot, uint32_t *pc, CliScriptInstruction_s instruction, const char *text, size_t textLength);
+
+/**
+ * @brief Parses a slot number parameter.
+ *
+ * \param[in]  pcCommandString - Command string;
+ * \param[in]  parameter       - Number of the parameter holding the slot;
+ * \param[out] slot            - Parsed slot number;
+ * \return     bool - true if the parameter is a valid slot number.
+ */
+static bool cliScriptParseSlot(const char *pcCommandString, UBaseType_t parameter, uint8_t *slot);
+
+/**
+ * @brief Returns the flash address of a slot.
+ *
+ * \param[in]  slot - Script slot;
+ * \return     uint32_t - Address of the slot.
+ */
+static uint32_t cliScriptSlotAddress(uint8_t slot);
+
+/**
+ * @brief Returns the flash address of the compiled program of a slot.
+ *
+ * \param[in]  slot - Script slot;
+ * \return     uint32_t - Address of the program.
+ */
+static uint32_t cliScriptCodeAddress(uint8_t slot);
+
+/**
+ * @brief Reads the header of the compiled program of a slot and checks that it matches the script.
+ *
+ * \param[in]  slot   - Script slot;
+ * \param[out] header - Header of the program;
+ * \return     bool - true if the slot has an up to date program.
+ */
+static bool cliScriptCodeValid(uint8_t slot, CliScriptCodeHeader_s *header);
+
+/**
+ * @brief Erases the compiled program of a slot if there is one.
+ *
+ * \param[in]  slot  - Script slot;
+ * \param[in]  force - Erase the program area even if it holds no complete program;
+ * \return     int16_t - CLI_SCRIPT_OK on success, CLI_SCRIPT_ERR_FLASH on failure.
+ */
+static int16_t cliScriptDiscardCode(uint8_t slot, bool force);
+
+/**
+ * @brief Reads one line of a script.
+ *
+ * \param[in]  slot   - Script slot;
+ * \param[in]  offset - Offset of the line in the slot;
+ * \param[out] line   - Buffer of CLI_SCRIPT_MAX_LINE_LENGTH + 1 bytes receiving the null-terminated line;
+ * \return     uint32_t - Offset of the next line, 0 at the end of the script.
+ */
+static uint32_t cliScriptReadLine(uint8_t slot, uint32_t offset, char *line);
+
+/**
+ * @brief Command definitions of the script commands.
+ */
+static const CLI_Command_Definition_t cliScriptDefinitions[] =
+    {
+        {
+            .pcCommand = "script",
+            .pcHelpString = "script add <slot> <line> | show <slot> | erase <slot> | compile <slot> - edits a stored command script \r\n",
+            .pxCommandInterpreter = cliScriptCommand,
+            .cExpectedNumberOfParameters = -1,
+        },
+        {
+            .pcCommand = "exec",
+            .pcHelpString = "exec <slot> [text] - executes a stored command script, compiled unless text is given, stopping at the first error \r\n",
+            .pxCommandInterpreter = cliScriptExecCommand,
+            .cExpectedNumberOfParameters = -1,
+            .usStackDepth = 384, // The script's commands run nested on the same stack
+        }};
+
+//=======================================================================[PUBLIC INTERFACE FUNCTIONS]===================================================================================== //
+
+/**
+ * @brief Returns the length of the script stored in a slot.
+ *
+ * \param[in]  slot - Script slot;
+ * \param[out] none;
+ * \return int32_t - Length of the script in bytes, 0 if the slot is empty, negative CliScriptStatus_e value on failure.
+ */
+int32_t CliScriptLength(uint8_t slot)
+{
+    uint8_t chunk[CLI_SCRIPT_READ_CHUNK] = {0};
+    int32_t length = 0;
+
+    if (slot >= CLI_SCRIPT_SLOT_COUNT)
+    {
+        return CLI_SCRIPT_ERR_INVALID;
+    }
+
+    if (cliScriptLengthKnown[slot])
+    {
+        return cliScriptLengths[slot];
+    }
+
+    /* Search for the first erased byte */
+    while (length < CLI_SCRIPT_SLOT_SIZE)
+    {
+        if (flash_read(&CLI_SCRIPT_FLASH, cliScriptSlotAddress(slot) + length, chunk, sizeof(chunk)) != ERR_NONE)
+        {
+            return CLI_SCRIPT_ERR_FLASH;
+        }
+
+        uint8_t *end = memchr(chunk, CLI_SCRIPT_ERASED, sizeof(chunk));
+        if (end != NULL)
+        {
+            length += (int32_t)(end - chunk);
+            break;
+        }
+
+        length += sizeof(chunk);
+    }
+
+    cliScriptLengths[slot] = length;
+    cliScriptLengthKnown[slot] = true;
+
+    return length;
+}
+
+/**
+ * @brief Executes the script stored in a slot.
+ *
+ * \param[in]  slot       - Script slot;
+ * \param[out] output     - Buffer receiving the output of the commands;
+ * \param[in]  outputSize - Size of the output buffer;
+ * \param[out] lineNumber - Number of lines executed, or the number of the line that failed;
+ * \return int16_t - CLI_SCRIPT_OK on success, negative CliScriptStatus_e value on failure.
+ */
+int16_t CliScriptRun(uint8_t slot, char *output, size_t outputSize, uint16_t *lineNumber)
+{
+    return cliScriptExecute(slot, true, output, outputSize, lineNumber);
+}
+
+/**
+ * @brief Compiles the script stored in a slot and stores the program in flash.
+ *
+ * The script is read twice: the first pass checks every line and writes one
+ * instruction per distinct command, the second writes the lines.
+ *
+ * \param[in]  slot       - Script slot;
+ * \param[out] lineNumber - Number of lines compiled, or the number of the line that cannot be compiled;
+ * \return int16_t - Size of the program in bytes on success, negative CliScriptStatus_e value on failure.
+ */
+int16_t CliScriptCompile(uint8_t slot, uint16_t *lineNumber)
+{
+    CLI_Definition_List_Item_t *commands[CLI_SCRIPT_MAX_COMMANDS] = {0};
+    CLI_Definition_List_Item_t *command = NULL;
+    CliScriptLine_s parsed = {0};
+    char line[CLI_SCRIPT_MAX_LINE_LENGTH + 1] = {0};
+    uint32_t pc = sizeof(CliScriptCodeHeader_s);
+    uint8_t commandCount = 0;
+    int16_t status = CLI_SCRIPT_OK;
+
+    *lineNumber = 0;
+
+    if (CliScriptLength(slot) <= 0)
+    {
+        return CLI_SCRIPT_ERR_INVALID;
+    }
+
+    /* The program may be the one being executed */
+    if ((FreeRTOS_CLIGetContext()->ucNesting & cliNESTING_SCRIPT) != 0U)
+    {
+        return CLI_SCRIPT_ERR_NESTED;
+    }
+
+    if (cliScriptDiscardCode(slot, true) != CLI_SCRIPT_OK)
+    {
+        return CLI_SCRIPT_ERR_FLASH;
+    }
+
+    for (uint8_t pass = 0; (pass < 2) && (status == CLI_SCRIPT_OK); pass++)
+    {
+        uint32_t offset = 0;
+
+        *lineNumber = 0;
+
+        while ((status == CLI_SCRIPT_OK) &&
+               ((offset = cliScriptReadLine(slot, offset, line)) != 0))
+        {
+            (*lineNumber)++;
+
+            if ((line[0] == '\0') ||
+                (line[0] == '#'))
+            {
+                continue;
+            }
+
+            status = cliScriptCompileLine(line, &parsed, &command);
+            if (status != CLI_SCRIPT_OK)
+            {
+                break;
+            }
+
+            uint8_t index = 0;
+            while ((index < commandCount) &&
+                   (commands[index] != command))
+            {
+                index++;
+            }
+
+            CliScriptInstruction_s instruction = {.command = index, .line = *lineNumber};
+
+            if (pass == 0)
+            {
+                if (index < commandCount)
+                {
+                    continue;
+                }
+
+                if (commandCount == CLI_SCRIPT_MAX_COMMANDS)
+                {
+                    status = CLI_SCRIPT_ERR_COMPILE;
+                    break;
+                }
+
+                /* The name as written, it is looked up again by the same rules when the program is loaded */
+                commands[commandCount++] = command;
+                instruction.op = CLI_SCRIPT_OP_COMMAND;
+                status = cliScriptEmit(slot, &pc, instruction, parsed.command, strcspn(parsed.command, " "));
+                continue;
+            }
+
+            size_t textLength = strlen(parsed.command);
+            uint32_t end = pc + sizeof(instruction) + textLength + 1U +
+                           ((parsed.runs > 1U) ? (2U * sizeof(instruction)) : 0U);
+            uint32_t loop = 0;
+
+            /* A conditional line is jumped over when its condition does not hold */
+            if (parsed.condition != CLI_SCRIPT_IF_ANY)
+            {
+                end += sizeof(instruction);
+                instruction.op = (parsed.condition == CLI_SCRIPT_IF_OK) ? CLI_SCRIPT_OP_JUMP_FAILED : CLI_SCRIPT_OP_JUMP_OK;
+                instruction.operand = (uint16_t)end;
+                status = cliScriptEmit(slot, &pc, instruction, NULL, 0);
+            }
+
+            if ((status == CLI_SCRIPT_OK) &&
+                (parsed.runs > 1U))
+            {
+                instruction.op = CLI_SCRIPT_OP_COUNT;
+                instruction.operand = parsed.runs;
+                status = cliScriptEmit(slot, &pc, instruction, NULL, 0);
+                loop = pc;
+            }
+
+            if (status == CLI_SCRIPT_OK)
+            {
+                instruction.op = parsed.tolerant ? CLI_SCRIPT_OP_TRY : CLI_SCRIPT_OP_RUN;
+                status = cliScriptEmit(slot, &pc, instruction, parsed.command, textLength);
+            }
+
+            if ((status == CLI_SCRIPT_OK) &&
+                (parsed.runs > 1U))
+            {
+                instruction.op = CLI_SCRIPT_OP_LOOP;
+                instruction.operand = (uint16_t)loop;
+                status = cliScriptEmit(slot, &pc, instruction, NULL, 0);
+            }
+        }
+    }
+
+    if (status == CLI_SCRIPT_OK)
+    {
+        CliScriptInstruction_s instruction = {.op = CLI_SCRIPT_OP_END, .line = *lineNumber};
+
+        status = cliScriptEmit(slot, &pc, instruction, NULL, 0);
+    }
+
+    /* Running out of room is a reason for a line not to compile */
+    if (status == CLI_SCRIPT_ERR_FULL)
+    {
+        status = CLI_SCRIPT_ERR_COMPILE;
+    }
+
+    if (status != CLI_SCRIPT_OK)
+    {
+        return status;
+    }
+
+    CliScriptCodeHeader_s header = {
+        .magic = CLI_SCRIPT_CODE_MAGIC,
+        .scriptLength = (uint32_t)CliScriptLength(slot),
+        .lineCount = *lineNumber,
+        .codeLength = (uint16_t)(pc - sizeof(CliScriptCodeHeader_s)),
+    };
+
+    if (flash_append(&CLI_SCRIPT_FLASH, cliScriptCodeAddress(slot), (uint8_t *)&header, sizeof(header)) != ERR_NONE)
+    {
+        return CLI_SCRIPT_ERR_FLASH;
+    }
+
+    return (int16_t)pc;
+}
+
+/**
+ * @brief Registers the "script" and "exec" commands with FreeRTOS CLI.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return int16_t - 0 on success, negative value on error.
+ */
+int16_t CliScriptCmdInit(void)
+{
+    int16_t status = 0;
+
+    for (size_t ind = 0; ind < (sizeof(cliScriptDefinitions) / sizeof(cliScriptDefinitions[0])); ind++)
+    {
+        if (FreeRTOS_CLIRegisterCommand(&cliScriptDefinitions[ind]) != pdPASS)
+        {
+            status = -1;
+        }
+    }
+
+    return status;
+}
+
+//=====================================================================[ PRIVATE FUNCTIONS ]============================================================================================== //
+
+/**
+ * @brief Command callback function for the "script" command.
+ *
+ * "script show" lists one line per call, keeping the offset of the next line
+ * in the command context.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the subcommand and its parameters;
+ * \return     pdTRUE if more output follows, otherwise pdFALSE.
+ */
+static BaseType_t cliScriptCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString)
+{
+    CLI_Command_Context_t *context = FreeRTOS_CLIGetContext();
+    BaseType_t subLength = 0;
+    BaseType_t slotLength = 0;
+    const char *sub = FreeRTOS_CLIGetParameter(pcCommandString, 1, &subLength);
+    const char *slotParam = FreeRTOS_CLIGetParameter(pcCommandString, 2, &slotLength);
+    uint8_t slot = 0;
+    uint16_t lineNumber = 0;
+    int16_t status = CLI_SCRIPT_OK;
+
+    if ((pcWriteBuffer == NULL) ||
+        (xWriteBufferLen == 0))
+    {
+        return pdFALSE;
+    }
+
+    if ((sub == NULL) ||
+        (!cliScriptParseSlot(pcCommandString, 2, &slot)))
+    {
+        status = CLI_SCRIPT_ERR_INVALID;
+    }
+    else if ((subLength == 4) && (strncmp(sub, "show", 4) == 0))
+    {
+        char line[CLI_SCRIPT_MAX_LINE_LENGTH + 1] = {0};
+        uint32_t next = cliScriptReadLine(slot, (uint32_t)context->uxIndex, line);
+
+        if (next == 0)
+        {
+            snprintf(pcWriteBuffer, xWriteBufferLen, "%s", (context->uxIndex == 0) ? "Script slot is empty\r\n" : "");
+            return pdFALSE;
+        }
+
+        /* pvCursor counts the lines listed so far */
+        context->pvCursor = (void *)((uintptr_t)context->pvCursor + 1U);
+        context->uxIndex = next;
+        snprintf(pcWriteBuffer, xWriteBufferLen, "%3u: %s\r\n", (unsigned)(uintptr_t)context->pvCursor, line);
+
+        return ((int32_t)next < CliScriptLength(slot)) ? pdTRUE : pdFALSE;
+    }
+    else if ((subLength == 5) && (strncmp(sub, "erase", 5) == 0))
+    {
+        uint32_t pages = CLI_SCRIPT_SLOT_SIZE / flash_get_page_size(&CLI_SCRIPT_FLASH);
+
+        cliScriptLengthKnown[slot] = false;
+        status = ((cliScriptDiscardCode(slot, false) == CLI_SCRIPT_OK) &&
+                  (flash_erase(&CLI_SCRIPT_FLASH, cliScriptSlotAddress(slot), pages) == ERR_NONE))
+                     ? CLI_SCRIPT_OK
+                     : CLI_SCRIPT_ERR_FLASH;
+        if (status == CLI_SCRIPT_OK)
+        {
+            cliScriptLengths[slot] = 0;
+            cliScriptLengthKnown[slot] = true;
+            snprintf(pcWriteBuffer, xWriteBufferLen, "OK\r\n");
+        }
+    }
+    else if ((subLength == 3) && (strncmp(sub, "add", 3) == 0))
+    {
+        /* The line is the rest of the command after the slot number */
+        const char *line = slotParam + slotLength;
+        int32_t length = CliScriptLength(slot);
+
+        while (*line == ' ')
+        {
+            line++;
+        }
+
+        size_t lineLength = strlen(line);
+
+        if ((lineLength == 0) ||
+            (lineLength > CLI_SCRIPT_MAX_LINE_LENGTH))
+        {
+            status = CLI_SCRIPT_ERR_INVALID;
+        }
+        else if ((length < 0) ||
+                 ((uint32_t)length + lineLength + 1U > CLI_SCRIPT_SLOT_SIZE))
+        {
+            status = (length < 0) ? (int16_t)length : CLI_SCRIPT_ERR_FULL;
+        }
+        else
+        {
+            uint32_t address = cliScriptSlotAddress(slot) + (uint32_t)length;
+            uint8_t newline = '\n';
+
+            cliScriptLengthKnown[slot] = false;
+            if ((cliScriptDiscardCode(slot, false) != CLI_SCRIPT_OK) ||
+                (flash_append(&CLI_SCRIPT_FLASH, address, (uint8_t *)line, (uint32_t)lineLength) != ERR_NONE) ||
+                (flash_append(&CLI_SCRIPT_FLASH, address + lineLength, &newline, 1) != ERR_NONE))
+            {
+                status = CLI_SCRIPT_ERR_FLASH;
+            }
+            else
+            {
+                cliScriptLengths[slot] = length + (int32_t)lineLength + 1;
+                cliScriptLengthKnown[slot] = true;
+                snprintf(pcWriteBuffer, xWriteBufferLen, "OK\r\n");
+            }
+        }
+    }
+    else if ((subLength == 7) && (strncmp(sub, "compile", 7) == 0))
+    {
+        int16_t size = CliScriptCompile(slot, &lineNumber);
+
+        status = (size < 0) ? size : CLI_SCRIPT_OK;
+        if (status == CLI_SCRIPT_OK)
+        {
+            snprintf(pcWriteBuffer, xWriteBufferLen, "compile: %u line(s) compiled to %d byte(s)\r\n", (unsigned)lineNumber, size);
+        }
+    }
+    else
+    {
+        status = CLI_SCRIPT_ERR_INVALID;
+    }
+
+    switch (status)
+    {
+    case CLI_SCRIPT_ERR_INVALID:
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_INVALID_ARGUMENT, cliScriptDefinitions[0].pcHelpString);
+        break;
+
+    case CLI_SCRIPT_ERR_COMPILE:
+    {
+        /* Unknown command, wrong parameter count, bad repeat count or no room left */
+        char message[48] = {0};
+
+        snprintf(message, sizeof(message), "compile: line %u cannot be compiled\r\n", (unsigned)lineNumber);
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_INVALID_ARGUMENT, message);
+        break;
+    }
+
+    case CLI_SCRIPT_ERR_NESTED:
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_NESTED, "compile: scripts cannot compile scripts\r\n");
+        break;
+
+    case CLI_SCRIPT_ERR_FULL:
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_FULL, "Script slot is full\r\n");
+        break;
+
+    case CLI_SCRIPT_ERR_FLASH:
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_FLASH, NULL);
+        break;
+
+    default:
+        break;
+    }
+
+    if (status != CLI_SCRIPT_OK)
+    {
+        FreeRTOS_CLISetStatus(cliSTATUS_FAILED);
+    }
+
+    return pdFALSE;
+}
+
+/**
+ * @brief Command callback function for the "exec" command.
+ *
+ * \param[out] pcWriteBuffer   - Buffer where the output string is stored;
+ * \param[in]  xWriteBufferLen - Maximum buffer length;
+ * \param[in]  pcCommandString - Command string with the slot number;
+ * \return     pdFALSE (indicates that the output has been fully written).
+ */
+static BaseType_t cliScriptExecCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString)
+{
+    uint8_t slot = 0;
+    uint16_t lineNumber = 0;
+    int16_t status = CLI_SCRIPT_ERR_INVALID;
+    TickType_t start = xTaskGetTickCount();
+    BaseType_t modeLength = 0;
+    BaseType_t extraLength = 0;
+    const char *mode = FreeRTOS_CLIGetParameter(pcCommandString, 2, &modeLength);
+
+    if ((pcWriteBuffer == NULL) ||
+        (xWriteBufferLen == 0))
+    {
+        return pdFALSE;
+    }
+
+    /* "text" executes the script line by line even if it is compiled, to compare both */
+    if (cliScriptParseSlot(pcCommandString, 1, &slot) &&
+        (FreeRTOS_CLIGetParameter(pcCommandString, 3, &extraLength) == NULL) &&
+        ((mode == NULL) ||
+         ((modeLength == 4) && (strncmp(mode, "text", 4) == 0))))
+    {
+        status = cliScriptExecute(slot, (mode == NULL), pcWriteBuffer, xWriteBufferLen, &lineNumber);
+    }
+
+    switch (status)
+    {
+    case CLI_SCRIPT_OK:
+        snprintf(pcWriteBuffer, xWriteBufferLen, "exec: %u line(s) executed in %lu tick(s)\r\n",
+                 (unsigned)lineNumber, (unsigned long)(xTaskGetTickCount() - start));
+        break;
+
+    case CLI_SCRIPT_ERR_COMMAND:
+        if (FreeRTOS_CLIGetFormat() != cliFORMAT_TEXT)
+        {
+            /* Binary or JSON output cannot be prefixed, report the failing line as a record */
+            CLI_Record_t record;
+
+            FreeRTOS_CLIRecordInit(&record, pcWriteBuffer, xWriteBufferLen);
+            FreeRTOS_CLIRecordBegin(&record);
+            FreeRTOS_CLIRecordUnsigned(&record, "error", cliERROR_FAILED);
+            FreeRTOS_CLIRecordUnsigned(&record, "line", lineNumber);
+            (void)FreeRTOS_CLIRecordEnd(&record);
+        }
+        else
+        {
+            /* Keep the failing command's output after the line number */
+            char prefix[32] = {0};
+            int prefixLength = snprintf(prefix, sizeof(prefix),
+                                        (FreeRTOS_CLIGetVerbosity() == cliVERBOSITY_TERSE) ? "L%u " : "exec: line %u failed: ",
+                                        (unsigned)lineNumber);
+            pcWriteBuffer[xWriteBufferLen - 1] = '\0';
+            size_t outputLength = strlen(pcWriteBuffer);
+
+            /* A buffer too small for the prefix keeps the output alone */
+            if ((size_t)prefixLength < xWriteBufferLen)
+            {
+                if ((size_t)prefixLength + outputLength >= xWriteBufferLen)
+                {
+                    outputLength = xWriteBufferLen - (size_t)prefixLength - 1;
+                }
+
+                memmove(&pcWriteBuffer[prefixLength], pcWriteBuffer, outputLength);
+                memcpy(pcWriteBuffer, prefix, (size_t)prefixLength);
+                pcWriteBuffer[prefixLength + outputLength] = '\0';
+            }
+        }
+        break;
+
+    case CLI_SCRIPT_ERR_NESTED:
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_NESTED, "exec: scripts cannot execute scripts\r\n");
+        break;
+
+    default:
+        FreeRTOS_CLIWriteError(pcWriteBuffer, xWriteBufferLen, cliERROR_INVALID_ARGUMENT, cliScriptDefinitions[1].pcHelpString);
+        break;
+    }
+
+    if (status != CLI_SCRIPT_OK)
+    {
+        FreeRTOS_CLISetStatus(cliSTATUS_FAILED);
+    }
+
+    return pdFALSE;
+}
+
+/**
+ * @brief Executes a script in a context nested in the current one.
+ *
+ * \param[in]  slot       - Script slot;
+ * \param[in]  compiled   - Execute the compiled program if it is up to date;
+ * \param[out] output     - Buffer receiving the output of the commands;
+ * \param[in]  outputSize - Size of the output buffer;
+ * \param[out] lineNumber - Number of lines executed, or the number of the line that failed;
+ * \return     int16_t - CLI_SCRIPT_OK on success, negative CliScriptStatus_e value on failure.
+ */
+static int16_t cliScriptExecute(uint8_t slot, bool compiled, char *output, size_t outputSize, uint16_t *lineNumber)
+{
+    CLI_Command_Context_t *outerContext = FreeRTOS_CLIGetContext();
+    CLI_Command_Context_t context;
+    int16_t status = CLI_SCRIPT_ERR_COMPILE;
+
+    *lineNumber = 0;
+
+    if (CliScriptLength(slot) < 0)
+    {
+        return CLI_SCRIPT_ERR_INVALID;
+    }
+
+    /* Nesting is a property of the calling context, a job and the console each run their own scripts */
+    if ((outerContext->ucNesting & cliNESTING_SCRIPT) != 0U)
+    {
+        return CLI_SCRIPT_ERR_NESTED;
+    }
+
+    /* The script's commands get the rest of the caller's arena */
+    size_t arenaSize = (outerContext->pucArena != NULL) ? (outerContext->xArenaSize - outerContext->xArenaUsed) : 0;
+    void *arena = (arenaSize > CLI_SCRIPT_ARENA_MARGIN) ? FreeRTOS_CLIArenaAlloc(arenaSize - CLI_SCRIPT_ARENA_MARGIN) : NULL;
+
+    FreeRTOS_CLIInitContext(&context, arena, (arena != NULL) ? (arenaSize - CLI_SCRIPT_ARENA_MARGIN) : 0U);
+    context.ucVerbosity = outerContext->ucVerbosity;
+    context.ucFormat = outerContext->ucFormat;
+    context.ucNesting = outerContext->ucNesting | cliNESTING_SCRIPT;
+
+    if (compiled)
+    {
+        status = cliScriptRunCode(slot, &context, output, outputSize, lineNumber);
+    }
+
+    /* No program, or a stale one that has not run any command */
+    if (status == CLI_SCRIPT_ERR_COMPILE)
+    {
+        status = cliScriptRunText(slot, &context, output, outputSize, lineNumber);
+    }
+
+    return status;
+}
+
+/**
+ * @brief Executes the text of a script.
+ *
+ * Every line is read, split into its conditions and its command, and handed
+ * to the command interpreter, which looks the command up and counts its
+ * parameters.
+ *
+ * \param[in]  slot       - Script slot;
+ * \param[in]  context    - Context the commands run in;
+ * \param[out] output     - Buffer receiving the output of the commands;
+ * \param[in]  outputSize - Size of the output buffer;
+ * \param[out] lineNumber - Number of lines executed, or the number of the line that failed;
+ * \return     int16_t - CLI_SCRIPT_OK on success, negative CliScriptStatus_e value on failure.
+ */
+static int16_t cliScriptRunText(uint8_t slot, CLI_Command_Context_t *context, char *output, size_t outputSize, uint16_t *lineNumber)
+{
+    char line[CLI_SCRIPT_MAX_LINE_LENGTH + 1] = {0};
+    CliScriptLine_s parsed = {0};
+    uint32_t offset = 0;
+    bool succeeded = true;
+
+    *lineNumber = 0;
+
+    while ((offset = cliScriptReadLine(slot, offset, line)) != 0)
+    {
+        (*lineNumber)++;
+
+        if ((line[0] == '\0') ||
+            (line[0] == '#'))
+        {
+            continue;
+        }
+
+        cliScriptParseLine(line, &parsed);
+
+        if (((parsed.condition == CLI_SCRIPT_IF_OK) && !succeeded) ||
+            ((parsed.condition == CLI_SCRIPT_IF_FAILED) && succeeded))
+        {
+            continue;
+        }
+
+        succeeded = (cliScriptRunLine(context, NULL, parsed.command, output, outputSize) == cliSTATUS_OK);
+
+        if (!succeeded &&
+            !parsed.tolerant)
+        {
+            return CLI_SCRIPT_ERR_COMMAND;
+        }
+    }
+
+    return CLI_SCRIPT_OK;
+}
+
+/**
+ * @brief Executes the compiled program of a script.
+ *
+ * The text of the last command run stays in the line buffer, so a loop reads
+ * its command from flash only once.
+ *
+ * \param[in]  slot       - Script slot;
+ * \param[in]  context    - Context the commands run in;
+ * \param[out] output     - Buffer receiving the output of the commands;
+ * \param[in]  outputSize - Size of the output buffer;
+ * \param[out] lineNumber - Number of lines executed, or the number of the line that failed;
+ * \return     int16_t - CLI_SCRIPT_OK on success, CLI_SCRIPT_ERR_COMPILE if there is no up to date program
+ *                        or one of its commands is no longer registered, in which case no command has run,
+ *                        other negative CliScriptStatus_e value on failure.
+ */
+static int16_t cliScriptRunCode(uint8_t slot, CLI_Command_Context_t *context, char *output, size_t outputSize, uint16_t *lineNumber)
+{
+    CLI_Definition_List_Item_t *commands[CLI_SCRIPT_MAX_COMMANDS] = {0};
+    CliScriptCodeHeader_s header = {0};
+    CliScriptInstruction_s instruction = {0};
+    char line[CLI_SCRIPT_MAX_LINE_LENGTH + 1] = {0};
+    uint32_t address = cliScriptCodeAddress(slot);
+    uint32_t pc = sizeof(header);
+    uint32_t lineOffset = 0; // Offset of the text held in line, 0 if none
+    uint16_t counter = 0;
+    bool succeeded = true;
+
+    if (!cliScriptCodeValid(slot, &header))
+    {
+        return CLI_SCRIPT_ERR_COMPILE;
+    }
+
+    while ((pc + sizeof(instruction)) <= (sizeof(header) + header.codeLength))
+    {
+        if (flash_read(&CLI_SCRIPT_FLASH, address + pc, (uint8_t *)&instruction, sizeof(instruction)) != ERR_NONE)
+        {
+            return CLI_SCRIPT_ERR_FLASH;
+        }
+
+        pc += sizeof(instruction);
+
+        switch (instruction.op)
+        {
+        case CLI_SCRIPT_OP_COMMAND:
+        case CLI_SCRIPT_OP_RUN:
+        case CLI_SCRIPT_OP_TRY:
+            if ((instruction.command >= CLI_SCRIPT_MAX_COMMANDS) ||
+                (instruction.operand > sizeof(line)))
+            {
+                return CLI_SCRIPT_ERR_FLASH;
+            }
+
+            if (lineOffset != pc)
+            {
+                if (flash_read(&CLI_SCRIPT_FLASH, address + pc, (uint8_t *)line, instruction.operand) != ERR_NONE)
+                {
+                    return CLI_SCRIPT_ERR_FLASH;
+                }
+                lineOffset = pc;
+            }
+
+            pc += instruction.operand;
+
+            if (instruction.op == CLI_SCRIPT_OP_COMMAND)
+            {
+                /* All the commands come before the first run, so a script can still fall back to its text */
+                commands[instruction.command] = FreeRTOS_CLIResolveCommand(line, output, outputSize);
+                if (commands[instruction.command] == NULL)
+                {
+                    return CLI_SCRIPT_ERR_COMPILE;
+                }
+                break;
+            }
+
+            if (commands[instruction.command] == NULL)
+            {
+                return CLI_SCRIPT_ERR_FLASH;
+            }
+
+            *lineNumber = instruction.line;
+            succeeded = (cliScriptRunLine(context, commands[instruction.command], line, output, outputSize) == cliSTATUS_OK);
+
+            if (!succeeded &&
+                (instruction.op == CLI_SCRIPT_OP_RUN))
+            {
+                return CLI_SCRIPT_ERR_COMMAND;
+            }
+            break;
+
+        case CLI_SCRIPT_OP_JUMP_OK:
+        case CLI_SCRIPT_OP_JUMP_FAILED:
+            if (succeeded == (instruction.op == CLI_SCRIPT_OP_JUMP_OK))
+            {
+                pc = instruction.operand;
+            }
+            break;
+
+        case CLI_SCRIPT_OP_COUNT:
+            counter = instruction.operand;
+            break;
+
+        case CLI_SCRIPT_OP_LOOP:
+            if (counter > 1U)
+            {
+                counter--;
+                pc = instruction.operand;
+            }
+            break;
+
+        case CLI_SCRIPT_OP_END:
+            *lineNumber = header.lineCount;
+            return CLI_SCRIPT_OK;
+
+        default:
+            return CLI_SCRIPT_ERR_FLASH;
+        }
+    }
+
+    return CLI_SCRIPT_ERR_FLASH;
+}
+
+/**
+ * @brief Runs one command line to completion in a nested context.
+ *
+ * \param[in]  context    - Context the command runs in;
+ * \param[in]  command    - Resolved command, NULL to look the command up;
+ * \param[in]  line       - Command line;
+ * \param[out] output     - Buffer receiving the output of the command, each chunk overwriting the previous one;
+ * \param[in]  outputSize - Size of the output buffer;
+ * \return     BaseType_t - Status of the command, cliSTATUS_OK on success.
+ */
+static BaseType_t cliScriptRunLine(CLI_Command_Context_t *context, CLI_Definition_List_Item_t *command, const char *line, char *output, size_t outputSize)
+{
+    CLI_Command_Context_t *outerContext = FreeRTOS_CLIGetContext();
+
+    FreeRTOS_CLISetContext(context);
+    if (command != NULL)
+    {
+        while (FreeRTOS_CLIProcessResolvedCommand(command, line, output, outputSize) != pdFALSE)
+        {
+        }
+    }
+    else
+    {
+        while (FreeRTOS_CLIProcessCommand(line, output, outputSize) != pdFALSE)
+        {
+        }
+    }
+    BaseType_t status = FreeRTOS_CLIGetStatus();
+    FreeRTOS_CLISetContext(outerContext);
+
+    return status;
+}
+
+/**
+ * @brief Splits a script line into its conditions and its command.
+ *
+ * \param[in]  text   - Script line, neither empty nor a comment;
+ * \param[out] parsed - Conditions and command of the line; runs is always 1;
+ * \return     none.
+ */
+static void cliScriptParseLine(const char *text, CliScriptLine_s *parsed)
+{
+    parsed->condition = CLI_SCRIPT_IF_ANY;
+    parsed->tolerant = false;
+    parsed->runs = 1;
+
+    if (*text == '?')
+    {
+        parsed->condition = CLI_SCRIPT_IF_OK;
+        text++;
+    }
+    else if (*text == '!')
+    {
+        parsed->condition = CLI_SCRIPT_IF_FAILED;
+        text++;
+    }
+
+    if (*text == '-')
+    {
+        parsed->tolerant = true;
+        text++;
+    }
+
+    while (*text == ' ')
+    {
+        text++;
+    }
+
+    parsed->command = text;
+}
+
+/**
+ * @brief Parses a script line for compilation and looks up its command.
+ *
+ * A "repeat <n> <command>" line that stops the script on failure becomes a
+ * loop over its command. With '-' it stays a "repeat" command, as its loop
+ * stops at the first failed run while a loop of tolerant runs would not.
+ *
+ * \param[in]  text    - Script line, neither empty nor a comment;
+ * \param[out] parsed  - Conditions, number of runs and command of the line;
+ * \param[out] command - Resolved command;
+ * \return     int16_t - CLI_SCRIPT_OK on success, CLI_SCRIPT_ERR_COMPILE if the line cannot be compiled.
+ */
+static int16_t cliScriptCompileLine(const char *text, CliScriptLine_s *parsed, CLI_Definition_List_Item_t **command)
+{
+    char message[48] = {0}; // Only receives the error of a group that failed to load
+    int8_t parameters = -1;
+    bool inWord = false;
+
+    cliScriptParseLine(text, parsed);
+
+#if (CLI_LOOP_MAX_RUNS > 0)
+    if (!parsed->tolerant &&
+        (strncmp(parsed->command, CLI_SCRIPT_REPEAT, strlen(CLI_SCRIPT_REPEAT)) == 0))
+    {
+        const char *count = parsed->command + strlen(CLI_SCRIPT_REPEAT);
+        char *end = NULL;
+        unsigned long runs = strtoul(count, &end, 10);
+
+        if ((end == count) ||
+            (*end != ' ') ||
+            (runs < 1U) ||
+            (runs > CLI_LOOP_MAX_RUNS) ||
+            (runs > UINT16_MAX))
+        {
+            return CLI_SCRIPT_ERR_COMPILE;
+        }
+
+        while (*end == ' ')
+        {
+            end++;
+        }
+
+        parsed->runs = (uint16_t)runs;
+        parsed->command = end;
+    }
+#endif /* CLI_LOOP_MAX_RUNS */
+
+    *command = FreeRTOS_CLIResolveCommand(parsed->command, message, sizeof(message));
+    if (*command == NULL)
+    {
+        return CLI_SCRIPT_ERR_COMPILE;
+    }
+
+    /* The program runs the line without counting its parameters */
+    for (const char *character = parsed->command; *character != '\0'; character++)
+    {
+        if (*character == ' ')
+        {
+            inWord = false;
+        }
+        else if (!inWord)
+        {
+            inWord = true;
+            parameters++;
+        }
+    }
+
+    if (((*command)->pxCommandLineDefinition->cExpectedNumberOfParameters >= 0) &&
+        (parameters != (*command)->pxCommandLineDefinition->cExpectedNumberOfParameters))
+    {
+        return CLI_SCRIPT_ERR_COMPILE;
+    }
+
+    return CLI_SCRIPT_OK;
+}
+
+/**
+ * @brief Appends an instruction and the text that follows it to a compiled program.
+ *
+ * \param[in]     slot        - Script slot;
+ * \param[in,out] pc          - Offset of the instruction, advanced past it;
+ * \param[in]     instruction - Instruction; the operand of an instruction followed by text is set here;
+ * \param[in]     text        - Text following the instruction, NULL if none;
+ * \param[in]     textLength  - Length of the text, without the terminator;
+ * \return        int16_t - CLI_SCRIPT_OK on success, negative CliScriptStatus_e value on failure.
+ */
+static int16_t cliScriptEmit(uint8_t slot, uint32_t *pc, CliScriptInstruction_s instruction, const char *text, size_t textLength)
+{
+    uint32_t address = cliScriptCodeAddress(slot) + *pc;
+    size_t size = (text != NULL) ? (textLength + 1U) : 0U;
+    uint8_t terminator = '\0';
+
+    if ((*pc + sizeof(instruction) + size) > CLI_SCRIPT_CODE_SIZE)
+    {
+        return CLI_SCRIPT_ERR_FULL;
+    }
+
+    if (text != NULL)
+    {
+        instruction.operand = (uint16_t)size;
+    }
+
+    if ((flash_append(&CLI_SCRIPT_FLASH, address, (uint8_t *)&instruction, sizeof(instruction)) != ERR_NONE) ||
+        ((text != NULL) &&
+         ((flash_append(&CLI_SCRIPT_FLASH, address + sizeof(instruction), (uint8_t *)text, (uint32_t)textLength) != ERR_NONE) ||
+          (flash_append(&CLI_SCRIPT_FLASH, address + sizeof(instruction) + textLength, &terminator, 1) != ERR_NONE))))
+    {
+        return CLI_SCRIPT_ERR_FLASH;
+    }
+
+    *pc += sizeof(instruction) + size;
+
+    return CLI_SCRIPT_OK;
+}
+
+/**
+ * @brief Parses a slot number parameter.
+ *
+ * \param[in]  pcCommandString - Command string;
+ * \param[in]  parameter       - Number of the parameter holding the slot;
+ * \param[out] slot            - Parsed slot number;
+ * \return     bool - true if the parameter is a valid slot number.
+ */
+static bool cliScriptParseSlot(const char *pcCommandString, UBaseType_t parameter, uint8_t *slot)
+{
+    BaseType_t length = 0;
+    const char *param = FreeRTOS_CLIGetParameter(pcCommandString, parameter, &length);
+    char *end = NULL;
+
+    if (param == NULL)
+    {
+        return false;
+    }
+
+    unsigned long value = strtoul(param, &end, 10);
+    if ((end != (param + length)) ||
+        (value >= CLI_SCRIPT_SLOT_COUNT))
+    {
+        return false;
+    }
+
+    *slot = (uint8_t)value;
+
+    return true;
+}
+
+/**
+ * @brief Returns the flash address of a slot.
+ *
+ * \param[in]  slot - Script slot;
+ * \return     uint32_t - Address of the slot.
+ */
+static uint32_t cliScriptSlotAddress(uint8_t slot)
+{
+    return CLI_SCRIPT_FLASH_ADDRESS + ((uint32_t)slot * CLI_SCRIPT_SLOT_SIZE);
+}
+
+/**
+ * @brief Returns the flash address of the compiled program of a slot.
+ *
+ * \param[in]  slot - Script slot;
+ * \return     uint32_t - Address of the program.
+ */
+static uint32_t cliScriptCodeAddress(uint8_t slot)
+{
+    return CLI_SCRIPT_CODE_ADDRESS + ((uint32_t)slot * CLI_SCRIPT_CODE_SIZE);
+}
+
+/**
+ * @brief Reads the header of the compiled program of a slot and checks that it matches the script.
+ *
+ * Editing a slot discards its program, the length is only checked against
+ * programs left behind by a script changed some other way.
+ *
+ * \param[in]  slot   - Script slot;
+ * \param[out] header - Header of the program;
+ * \return     bool - true if the slot has an up to date program.
+ */
+static bool cliScriptCodeValid(uint8_t slot, CliScriptCodeHeader_s *header)
+{
+    int32_t length = CliScriptLength(slot);
+
+    return (length > 0) &&
+           (flash_read(&CLI_SCRIPT_FLASH, cliScriptCodeAddress(slot), (uint8_t *)header, sizeof(*header)) == ERR_NONE) &&
+           (header->magic == CLI_SCRIPT_CODE_MAGIC) &&
+           (header->scriptLength == (uint32_t)length) &&
+           (header->codeLength <= (CLI_SCRIPT_CODE_SIZE - sizeof(*header)));
+}
+
+/**
+ * @brief Erases the compiled program of a slot if there is one.
+ *
+ * A program area without a magic number holds no program or an unfinished
+ * one, which is never executed, so it is only erased when forced.
+ *
+ * \param[in]  slot  - Script slot;
+ * \param[in]  force - Erase the program area even if it holds no complete program;
+ * \return     int16_t - CLI_SCRIPT_OK on success, CLI_SCRIPT_ERR_FLASH on failure.
+ */
+static int16_t cliScriptDiscardCode(uint8_t slot, bool force)
+{
+    uint32_t magic = CLI_SCRIPT_ERASED_MAGIC;
+    uint32_t pages = CLI_SCRIPT_CODE_SIZE / flash_get_page_size(&CLI_SCRIPT_FLASH);
+
+    if (!force)
+    {
+        if (flash_read(&CLI_SCRIPT_FLASH, cliScriptCodeAddress(slot), (uint8_t *)&magic, sizeof(magic)) != ERR_NONE)
+        {
+            return CLI_SCRIPT_ERR_FLASH;
+        }
+
+        if (magic == CLI_SCRIPT_ERASED_MAGIC)
+        {
+            return CLI_SCRIPT_OK;
+        }
+    }
+
+    return (flash_erase(&CLI_SCRIPT_FLASH, cliScriptCodeAddress(slot), pages) == ERR_NONE) ? CLI_SCRIPT_OK : CLI_SCRIPT_ERR_FLASH;
+}
+
+/**
+ * @brief Reads one line of a script.
+ *
+ * A line longer than the buffer is truncated.
+ *
+ * \param[in]  slot   - Script slot;
+ * \param[in]  offset - Offset of the line in the slot;
+ * \param[out] line   - Buffer of CLI_SCRIPT_MAX_LINE_LENGTH + 1 bytes receiving the null-terminated line;
+ * \return     uint32_t - Offset of the next line, 0 at the end of the script.
+ */
+static uint32_t cliScriptReadLine(uint8_t slot, uint32_t offset, char *line)
+{
+    int32_t length = CliScriptLength(slot);
+    uint32_t available = 0;
+
+    if ((length <= 0) ||
+        (offset >= (uint32_t)length))
+    {
+        return 0;
+    }
+
+    available = (uint32_t)length - offset;
+    if (available > CLI_SCRIPT_MAX_LINE_LENGTH + 1U)
+    {
+        available = CLI_SCRIPT_MAX_LINE_LENGTH + 1U;
+    }
+
+    if (flash_read(&CLI_SCRIPT_FLASH, cliScriptSlotAddress(slot) + offset, (uint8_t *)line, available) != ERR_NONE)
+    {
+        return 0;
+    }
+
+    char *end = memchr(line, '\n', available);
+    uint32_t lineLength = (end != NULL) ? (uint32_t)(end - line) : (available - 1U);
+
+    line[lineLength] = '\0';
+
+    /* Strip the carriage return of scripts uploaded with CR LF line endings */
+    if ((lineLength > 0) &&
+        (line[lineLength - 1] == '\r'))
+    {
+        line[lineLength - 1] = '\0';
+    }
+
+    return offset + lineLength + 1U;
+}
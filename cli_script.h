@@ -0,0 +1,133 @@
+/**
+ * @file cli_script.h
+ * @brief Command scripts stored in flash and executed locally by the CLI.
+ *
+ * @details
+ * This file declares the interface for command scripts. A script is a list of
+ * command lines kept in one of several flash slots. Once uploaded with the
+ * "script" command, a script is executed with "exec <slot>" or at startup:
+ * each line is read from flash and passed straight to the command interpreter,
+ * without going through the UART and without echo. Execution stops at the first
+ * command that fails.
+ *
+ * Empty lines and lines starting with '#' are skipped. A line may start with
+ * conditions on the exit status of the commands before it:
+ *
+ *   -<command>    a failure of the command does not stop the script
+ *   ?<command>    runs only if the last command that ran succeeded
+ *   !<command>    runs only if the last command that ran failed
+ *
+ * '?' or '!' may be followed by '-'. Together they test a command without
+ * stopping on its failure and react to it, e.g. "-selftest" then "!reset".
+ *
+ * "script compile <slot>" translates a script into a compact program kept in
+ * flash next to it: every command is looked up once, when the program is
+ * loaded, and the lines only keep the text their callbacks parse. "repeat <n>"
+ * lines become a counted jump and the conditions become jumps on the last
+ * status, so the interpreter does not read, split, look up or count a line.
+ * The arguments are not typed constants: command callbacks take their
+ * parameters as a string, so each callback still parses its arguments on
+ * every run. "exec" runs the compiled program while it matches the script and
+ * the text otherwise; editing a slot discards its program.
+ *
+ * "bench <n> exec <slot>" and "bench <n> exec <slot> text" run the two forms
+ * for comparison. No figures have been measured on target, and no claim is
+ * made about how much faster the compiled form is.
+ *
+ * @date Created on 17.10.2026
+ * @author Yauheni Bialkou
+ */
+
+#ifndef CLI_SCRIPT_H
+#define CLI_SCRIPT_H
+
+//================================================================[INCLUDE]================================================================================================================//
+
+#include "FreeRTOS.h"     // FreeRTOS kernel headers
+#include "FreeRTOS_CLI.h" // FreeRTOS CLI API
+#include "hal_flash.h"    // Flash driver used to store the scripts
+#include "driver_init.h"  // Hardware initialization functions (depends on your project setup)
+
+//===========================================================[MACRO DEFINITIONS]===========================================================================================================//
+
+#define CLI_SCRIPT_FLASH FLASH_0            // Flash descriptor of the script slots (depends on your project setup)
+#define CLI_SCRIPT_FLASH_ADDRESS 0x38000    // Start address of the first script slot (depends on your project setup)
+#define CLI_SCRIPT_SLOT_SIZE 8192           // Size of one script slot, a multiple of the erase size
+#define CLI_SCRIPT_SLOT_COUNT 2             // Number of script slots
+#define CLI_SCRIPT_MAX_LINE_LENGTH 128      // Maximum length of a script line, in characters
+
+#define CLI_SCRIPT_CODE_ADDRESS 0x36000     // Start address of the compiled program of the first slot (depends on your project setup)
+#define CLI_SCRIPT_CODE_SIZE 4096           // Size of the compiled program of one slot, a multiple of the erase size
+#define CLI_SCRIPT_MAX_COMMANDS 16          // Maximum number of different commands in a compiled script
+
+#define CLI_SCRIPT_BOOT_SLOT 0              // Slot executed silently at startup, -1 to execute no script at startup
+
+//========================================================[DATA TYPES DEFINITIONS]=========================================================================================================//
+
+/**
+ * @brief Enumeration for script statuses.
+ *
+ * Negative values are returned by the script functions on failure.
+ */
+typedef enum
+{
+    CLI_SCRIPT_OK = 0,                // Operation successful
+    CLI_SCRIPT_ERR_INVALID = -1,      // Invalid slot number or line
+    CLI_SCRIPT_ERR_FULL = -2,         // No room left in the slot
+    CLI_SCRIPT_ERR_FLASH = -3,        // A flash operation failed
+    CLI_SCRIPT_ERR_COMMAND = -4,      // A command of the script failed
+    CLI_SCRIPT_ERR_NESTED = -5,       // A script tried to execute a script
+    CLI_SCRIPT_ERR_COMPILE = -6       // A line of the script cannot be compiled
+
+} CliScriptStatus_e;
+
+//===========================================================[PUBLIC INTERFACE]============================================================================================================//
+
+/**
+ * @brief Returns the length of the script stored in a slot.
+ *
+ * \param[in]  slot - Script slot;
+ * \param[out] none;
+ * \return int32_t - Length of the script in bytes, 0 if the slot is empty, negative CliScriptStatus_e value on failure.
+ */
+int32_t CliScriptLength(uint8_t slot);
+
+/**
+ * @brief Executes the script stored in a slot.
+ *
+ * Must be called from a command callback or from the task that runs commands,
+ * as the script's commands are executed in a context nested in the current one.
+ * The compiled program of the slot is executed if it is up to date.
+ * The output of the script's commands is discarded; when a command fails its
+ * output is left in the output buffer.
+ *
+ * \param[in]  slot       - Script slot;
+ * \param[out] output     - Buffer receiving the output of the commands;
+ * \param[in]  outputSize - Size of the output buffer;
+ * \param[out] lineNumber - Number of lines executed, or the number of the line that failed;
+ * \return int16_t - CLI_SCRIPT_OK on success, negative CliScriptStatus_e value on failure.
+ */
+int16_t CliScriptRun(uint8_t slot, char *output, size_t outputSize, uint16_t *lineNumber);
+
+/**
+ * @brief Compiles the script stored in a slot and stores the program in flash.
+ *
+ * Every command of the script must be registered and get the number of
+ * parameters it expects.
+ *
+ * \param[in]  slot       - Script slot;
+ * \param[out] lineNumber - Number of lines compiled, or the number of the line that cannot be compiled;
+ * \return int16_t - Size of the program in bytes on success, negative CliScriptStatus_e value on failure.
+ */
+int16_t CliScriptCompile(uint8_t slot, uint16_t *lineNumber);
+
+/**
+ * @brief Registers the "script" and "exec" commands with FreeRTOS CLI.
+ *
+ * \param[in]  none;
+ * \param[out] none;
+ * \return int16_t - 0 on success, negative value on error.
+ */
+int16_t CliScriptCmdInit(void);
+
+#endif /* CLI_SCRIPT_H */